@@ -71,6 +71,32 @@ private Q_SLOTS:
         QCOMPARE(m_kPlotAxis->majorTickMarks(), QList<double>() << 5.0 << 10.0 << 15.0 << 20.0 << 25.0 << 30.0);
     }
 
+    void testLogTickMarks()
+    {
+        KPlotAxis axis;
+        QCOMPARE(axis.isLogScale(), false);
+
+        axis.setLogScale(true);
+        QCOMPARE(axis.isLogScale(), true);
+
+        axis.setTickMarks(1.0, 999.0); // from 1 to 1000
+        QCOMPARE(axis.majorTickMarks(), QList<double>() << 1.0 << 10.0 << 100.0 << 1000.0);
+        QCOMPARE(axis.minorTickMarks().size(), 24);
+        QCOMPARE(axis.minorTickMarks().first(), 2.0);
+        QCOMPARE(axis.minorTickMarks().last(), 900.0);
+
+        // ranges within a decade fall back to linear tickmarks
+        axis.setTickMarks(200.0, 600.0);
+        QCOMPARE(axis.majorTickMarks(), QList<double>() << 200.0 << 400.0 << 600.0 << 800.0);
+        QVERIFY(!axis.minorTickMarks().isEmpty());
+
+        // and so do ranges across a single decade
+        axis.setTickMarks(5.0, 45.0);
+        QVERIFY(axis.majorTickMarks().size() >= 2);
+        QVERIFY(axis.majorTickMarks().first() >= 5.0);
+        QVERIFY(axis.majorTickMarks().last() <= 50.0);
+    }
+
 private:
     KPlotAxis *m_kPlotAxis;
 };
@@ -0,0 +1,204 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "kplotkernels_p.h"
+
+#include <QList>
+#include <QRandomGenerator>
+#include <QTest>
+
+using KPlotKernels::MinMax;
+
+class KPlotKernelsBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    // The straightforward reduction the kernels must agree with
+    static MinMax reference(const double *values, qsizetype n, qsizetype stride, const double *other = nullptr)
+    {
+        MinMax r;
+        for (qsizetype i = 0; i < n; ++i) {
+            const double x = values[i * stride];
+            if (!qIsFinite(x) || (other && !qIsFinite(other[i]))) {
+                continue;
+            }
+            if (x < r.min) {
+                r.min = x;
+                r.argMin = i;
+            }
+            if (x > r.max) {
+                r.max = x;
+                r.argMax = i;
+            }
+        }
+        return r;
+    }
+
+    // Small integers, so that the extremes occur several times, with some
+    // values that are not finite
+    static QList<double> createValues(qsizetype n)
+    {
+        QRandomGenerator random(n);
+        QList<double> values(n);
+        for (double &v : values) {
+            const int k = random.bounded(100);
+            v = k < 3 ? qQNaN() : k < 5 ? (k == 3 ? qInf() : -qInf()) : random.bounded(-50, 50);
+        }
+        return values;
+    }
+
+private Q_SLOTS:
+    void testMinMax_data()
+    {
+        QTest::addColumn<qsizetype>("n");
+        QTest::addColumn<qsizetype>("stride");
+
+        for (qsizetype n : {0, 1, 3, 1023, 1025, 5000, 2000000}) {
+            for (qsizetype stride : {1, 3}) {
+                QTest::addRow("%lld/%lld", qlonglong(n), qlonglong(stride)) << n << stride;
+            }
+        }
+    }
+
+    void testMinMax()
+    {
+        QFETCH(qsizetype, n);
+        QFETCH(qsizetype, stride);
+
+        const QList<double> values = createValues(n * stride);
+        const MinMax expected = reference(values.constData(), n, stride);
+        const MinMax r = KPlotKernels::minMax(values.constData(), n, stride);
+        QCOMPARE(r.isEmpty(), expected.isEmpty());
+        QCOMPARE(r.argMin, expected.argMin);
+        QCOMPARE(r.argMax, expected.argMax);
+        if (!r.isEmpty()) {
+            QCOMPARE(r.min, expected.min);
+            QCOMPARE(r.max, expected.max);
+        }
+    }
+
+    void testMinMax2_data()
+    {
+        QTest::addColumn<qsizetype>("n");
+
+        for (qsizetype n : {0, 1, 3, 1023, 1025, 5000, 2000000}) {
+            QTest::addRow("%lld", qlonglong(n)) << n;
+        }
+    }
+
+    void testMinMax2()
+    {
+        QFETCH(qsizetype, n);
+
+        const QList<double> xs = createValues(n);
+        const QList<double> ys = createValues(n + 1).mid(1);
+        MinMax x;
+        MinMax y;
+        KPlotKernels::minMax2(xs.constData(), ys.constData(), n, &x, &y);
+        const MinMax expectedX = reference(xs.constData(), n, 1, ys.constData());
+        const MinMax expectedY = reference(ys.constData(), n, 1, xs.constData());
+        QCOMPARE(x.argMin, expectedX.argMin);
+        QCOMPARE(x.argMax, expectedX.argMax);
+        QCOMPARE(y.argMin, expectedY.argMin);
+        QCOMPARE(y.argMax, expectedY.argMax);
+    }
+
+    void testNotFinite()
+    {
+        const double values[] = {qQNaN(), qInf(), -qInf(), qQNaN()};
+        QVERIFY(KPlotKernels::minMax(values, 4).isEmpty());
+        QVERIFY(KPlotKernels::minMax(values, 0).isEmpty());
+
+        const double xs[] = {1, qQNaN(), 5};
+        const double ys[] = {qInf(), 7, 2};
+        MinMax x;
+        MinMax y;
+        KPlotKernels::minMax2(xs, ys, 3, &x, &y);
+        QCOMPARE(x.argMin, 2);
+        QCOMPARE(x.argMax, 2);
+        QCOMPARE(y.min, 2.0);
+        QCOMPARE(y.max, 2.0);
+    }
+
+    void benchmarkMinMax_data()
+    {
+        QTest::addColumn<qsizetype>("n");
+        QTest::addColumn<bool>("kernel");
+
+        for (qsizetype n : {1000, 100000, 10000000}) {
+            QTest::addRow("reference/%lld", qlonglong(n)) << n << false;
+            QTest::addRow("kernel/%lld", qlonglong(n)) << n << true;
+        }
+    }
+
+    void benchmarkMinMax()
+    {
+        QFETCH(qsizetype, n);
+        QFETCH(bool, kernel);
+
+        const QList<double> values = createValues(n);
+        MinMax r;
+        if (kernel) {
+            QBENCHMARK {
+                r = KPlotKernels::minMax(values.constData(), n);
+            }
+        } else {
+            QBENCHMARK {
+                r = reference(values.constData(), n, 1);
+            }
+        }
+        QVERIFY(!r.isEmpty());
+    }
+
+    void benchmarkMinMaxStrided()
+    {
+        const qsizetype n = 1000000;
+        const QList<double> values = createValues(2 * n);
+        MinMax r;
+        QBENCHMARK {
+            r = KPlotKernels::minMax(values.constData() + 1, n, 2);
+        }
+        QVERIFY(!r.isEmpty());
+    }
+
+    void benchmarkMinMax2_data()
+    {
+        QTest::addColumn<qsizetype>("n");
+        QTest::addColumn<bool>("kernel");
+
+        for (qsizetype n : {1000, 100000, 10000000}) {
+            QTest::addRow("reference/%lld", qlonglong(n)) << n << false;
+            QTest::addRow("kernel/%lld", qlonglong(n)) << n << true;
+        }
+    }
+
+    void benchmarkMinMax2()
+    {
+        QFETCH(qsizetype, n);
+        QFETCH(bool, kernel);
+
+        const QList<double> xs = createValues(n);
+        const QList<double> ys = createValues(n + 1).mid(1);
+        MinMax x;
+        MinMax y;
+        if (kernel) {
+            QBENCHMARK {
+                KPlotKernels::minMax2(xs.constData(), ys.constData(), n, &x, &y);
+            }
+        } else {
+            QBENCHMARK {
+                x = reference(xs.constData(), n, 1, ys.constData());
+                y = reference(ys.constData(), n, 1, xs.constData());
+            }
+        }
+        QVERIFY(!x.isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(KPlotKernelsBenchmark)
+
+#include "kplotkernelsbenchmark.moc"
@@ -8,8 +8,13 @@
 #include <kplotpoint.h>
 
 #include <QBrush>
+#include <QColor>
 #include <QPen>
+#include <QRectF>
 #include <QTest>
+#include <QThread>
+
+#include <memory>
 
 static const QColor DEFAULT_COLOR = Qt::blue;
 static const QColor MODIFIED_COLOR = Qt::red;
@@ -151,6 +156,43 @@ private Q_SLOTS:
         QCOMPARE(m_kPlotObject->pointStyle(), KPlotObject::Star);
     }
 
+    void testPointDensityLimit()
+    {
+        QCOMPARE(m_kPlotObject->pointDensityLimit(), 1.0);
+
+        m_kPlotObject->setPointDensityLimit(0.0);
+        QCOMPARE(m_kPlotObject->pointDensityLimit(), 0.0);
+    }
+
+    void testPointColumns()
+    {
+        QVERIFY(m_kPlotObject->colorTable().isEmpty());
+        QCOMPARE(m_kPlotObject->minimumValue(), 0.0);
+        QCOMPARE(m_kPlotObject->maximumValue(), 1.0);
+
+        m_kPlotObject->setColorTable({Qt::blue, Qt::green});
+        QCOMPARE(m_kPlotObject->colorTable(), QList<QColor>({Qt::blue, Qt::green}));
+        m_kPlotObject->setValueRange(-1.0, 2.0);
+        QCOMPARE(m_kPlotObject->minimumValue(), -1.0);
+        QCOMPARE(m_kPlotObject->maximumValue(), 2.0);
+
+        // The columns follow the points they belong to
+        for (int i = 0; i < 4; ++i) {
+            m_kPlotObject->addPoint(i, i);
+        }
+        m_kPlotObject->setPointValues({0.0, 1.0, 2.0});
+        m_kPlotObject->setPointSizes({4.0, 5.0, 6.0, 7.0});
+        m_kPlotObject->removePoint(1);
+        QCOMPARE(m_kPlotObject->pointValues(), QList<double>({0.0, 2.0}));
+        QCOMPARE(m_kPlotObject->pointSizes(), QList<double>({4.0, 6.0, 7.0}));
+        m_kPlotObject->removePoint(2);
+        QCOMPARE(m_kPlotObject->pointValues(), QList<double>({0.0, 2.0}));
+        QCOMPARE(m_kPlotObject->pointSizes(), QList<double>({4.0, 6.0}));
+        m_kPlotObject->clearPoints();
+        QVERIFY(m_kPlotObject->pointValues().isEmpty());
+        QVERIFY(m_kPlotObject->pointSizes().isEmpty());
+    }
+
     void testAddPoint()
     {
         // verify list is empty
@@ -208,6 +250,215 @@ private Q_SLOTS:
         QCOMPARE(m_kPlotObject->points().size(), 0);
     }
 
+    void testSortedByX()
+    {
+        KPlotObject object;
+        QVERIFY(object.isSortedByX());
+
+        object.addPoint(1, 1);
+        object.addPoint(2, 0);
+        object.addPoint(2, 5);
+        QVERIFY(object.isSortedByX());
+
+        object.addPoint(0, 0);
+        QVERIFY(!object.isSortedByX());
+
+        // removing points keeps the order, but is not re-checked
+        object.removePoint(3);
+        object.pointsChanged();
+        QVERIFY(object.isSortedByX());
+
+        // points modified in place
+        object.points().at(0)->setX(10);
+        object.pointsChanged();
+        QVERIFY(!object.isSortedByX());
+
+        object.clearPoints();
+        QVERIFY(object.isSortedByX());
+    }
+
+    void testPointEdits()
+    {
+        KPlotObject object;
+        object.addPoint(1, 1);
+        object.addPoint(2, 0);
+        object.addPoint(3, 5);
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(1, 0), QPointF(3, 5)));
+
+        // points edited in place are picked up without pointsChanged()
+        object.points().at(0)->setX(10);
+        QVERIFY(!object.isSortedByX());
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(2, 0), QPointF(10, 5)));
+        object.points().at(1)->setPosition(QPointF(-1, -2));
+        object.points().at(2)->setY(7);
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(-1, -2), QPointF(10, 7)));
+
+        // a removed point belongs to the caller, and no longer to the object
+        KPlotPoint *point = object.points().at(0);
+        object.removePoint(0);
+        point->setX(100);
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(-1, -2), QPointF(3, 7)));
+        delete point;
+    }
+
+    void testBoundingRect()
+    {
+        KPlotObject object;
+        QVERIFY(object.boundingRect().isNull());
+
+        object.addPoint(1, 2);
+        QCOMPARE(object.boundingRect(), QRectF(1, 2, 0, 0));
+        object.addPoint(-1, 5);
+        object.addPoint(3, 0);
+        object.addPoint(qQNaN(), 100);
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(-1, 0), QPointF(3, 5)));
+
+        // removing a point on the edge shrinks the rectangle
+        object.removePoint(2);
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(-1, 2), QPointF(1, 5)));
+        object.removePoint(2);
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(-1, 2), QPointF(1, 5)));
+
+        // points modified in place
+        object.points().at(0)->setY(-4);
+        object.pointsChanged();
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(-1, -4), QPointF(1, 5)));
+
+        object.clearPoints();
+        QVERIFY(object.boundingRect().isNull());
+    }
+
+    void testUniformSamples()
+    {
+        KPlotObject object;
+        QVERIFY(!object.isUniformlySampled());
+        object.addPoint(10, 10, QStringLiteral("label"));
+        object.setUniformSamples(1.0, 0.5, {3, 0, qQNaN(), 4, 2});
+        QVERIFY(object.isUniformlySampled());
+        QCOMPARE(object.sampleStart(), 1.0);
+        QCOMPARE(object.sampleInterval(), 0.5);
+        QVERIFY(object.isSortedByX());
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(1, 0), QPointF(3, 4)));
+
+        // appending continues the x-coordinates
+        object.appendSamples({5, -1});
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(1, -1), QPointF(4, 5)));
+
+        // trimming either end keeps the samples uniform
+        object.removePoint(0);
+        object.removePoint(5);
+        QVERIFY(object.isUniformlySampled());
+        QCOMPARE(object.sampleStart(), 1.5);
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(1.5, 0), QPointF(3.5, 5)));
+
+        // the points are created when they are asked for
+        const QList<KPlotPoint *> points = object.points();
+        QVERIFY(!object.isUniformlySampled());
+        QCOMPARE(points.size(), 5);
+        QCOMPARE(points.at(0)->position(), QPointF(1.5, 0));
+        QCOMPARE(points.at(4)->position(), QPointF(3.5, 5));
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(1.5, 0), QPointF(3.5, 5)));
+        object.appendSamples({7});
+        QCOMPARE(object.points().size(), 5);
+
+        // so is removing from the middle
+        object.setUniformSamples(0.0, 1.0, {1, 2, 3});
+        object.removePoint(1);
+        QVERIFY(!object.isUniformlySampled());
+        QCOMPARE(object.points().at(1)->position(), QPointF(2, 3));
+
+        // decreasing x-coordinates
+        object.setUniformSamples(0.0, -1.0, {1, 2, 3});
+        QVERIFY(!object.isSortedByX());
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(-2, 1), QPointF(0, 3)));
+
+        // points continuing the samples keep them uniform, also in a
+        // rolling window
+        object.setUniformSamples(0.0, 0.1, {0, 1, 2});
+        for (int i = 3; i < 100; ++i) {
+            object.addPoint(i * 0.1, i);
+            object.removePoint(0);
+        }
+        QVERIFY(object.isUniformlySampled());
+        QCOMPARE(object.sampleStart(), 9.7);
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(9.7, 97), QPointF(9.9, 99)));
+
+        object.setUniformSamples(0.0, 1.0, {1, 2, 3});
+        object.setSampleQueueCapacity(4);
+        QVERIFY(object.pushSample(3, 4));
+        QCOMPARE(object.takeSamples(), 1);
+        KPlotPoint *point = new KPlotPoint(4, 5);
+        object.addPoint(point);
+        QVERIFY(object.isUniformlySampled());
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(0, 1), QPointF(4, 5)));
+        object.setSampleQueueCapacity(0);
+
+        // editing a point stores them all
+        point->setY(7);
+        QVERIFY(!object.isUniformlySampled());
+        QCOMPARE(object.points().size(), 5);
+        QCOMPARE(object.points().at(4), point);
+        QCOMPARE(object.boundingRect(), QRectF(QPointF(0, 1), QPointF(4, 7)));
+
+        // and so does adding any other point
+        object.setUniformSamples(0.0, 1.0, {1, 2, 3});
+        object.addPoint(3, 4, QStringLiteral("label"));
+        QVERIFY(!object.isUniformlySampled());
+        QCOMPARE(object.points().at(3)->label(), QStringLiteral("label"));
+
+        object.clearPoints();
+        QVERIFY(!object.isUniformlySampled());
+        QVERIFY(object.boundingRect().isNull());
+    }
+
+    void testSampleQueue()
+    {
+        KPlotObject object;
+        QCOMPARE(object.sampleQueueCapacity(), 0);
+        QVERIFY(!object.pushSample(0, 0));
+
+        // the capacity is rounded up to a power of two, and a full queue
+        // drops samples
+        object.setSampleQueueCapacity(100);
+        QCOMPARE(object.sampleQueueCapacity(), 128);
+        for (int i = 0; i < 128; ++i) {
+            QVERIFY(object.pushSample(i, -i));
+        }
+        QVERIFY(!object.pushSample(128, -128));
+        QCOMPARE(object.takeSamples(), 128);
+        QCOMPARE(object.takeSamples(), 0);
+        QCOMPARE(object.points().size(), 128);
+        QCOMPARE(object.points().at(127)->position(), QPointF(127, -127));
+
+        // samples pushed by another thread arrive in order
+        const int count = 10000;
+        object.clearPoints();
+        object.setSampleQueueCapacity(256);
+        std::unique_ptr<QThread> thread(QThread::create([&object] {
+            for (int i = 0; i < count; ++i) {
+                while (!object.pushSample(i, 2 * i)) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }));
+        thread->start();
+        while (object.points().size() < count) {
+            if (object.takeSamples() == 0) {
+                QThread::yieldCurrentThread();
+            }
+        }
+        QVERIFY(thread->wait());
+        QCOMPARE(object.points().size(), count);
+        QVERIFY(object.isSortedByX());
+        const QList<KPlotPoint *> points = object.points();
+        for (int i = 0; i < count; ++i) {
+            QCOMPARE(points.at(i)->position(), QPointF(i, 2 * i));
+        }
+
+        object.setSampleQueueCapacity(0);
+        QCOMPARE(object.sampleQueueCapacity(), 0);
+    }
+
 private:
     KPlotObject *m_kPlotObject;
 };
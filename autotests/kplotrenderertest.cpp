@@ -0,0 +1,434 @@
+/*
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <kplotaxis.h>
+#include <kplotobject.h>
+#include <kplotpoint.h>
+#include <kplotrenderer.h>
+#include <kplotwidget.h>
+
+#include <qtest_widgets.h>
+
+#include <QImage>
+#include <QPainter>
+#include <QThread>
+
+#include <memory>
+
+class KPlotRendererTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static KPlotObject *createObject()
+    {
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        object->setShowPoints(true);
+        for (int i = 0; i <= 20; ++i) {
+            object->addPoint(i, (i * 7) % 11);
+        }
+        return object;
+    }
+
+private Q_SLOTS:
+    void testDefaults()
+    {
+        KPlotRenderer renderer;
+        QCOMPARE(renderer.size(), QSize());
+        QCOMPARE(renderer.dataRect(), QRectF(0.0, 0.0, 1.0, 1.0));
+        QVERIFY(renderer.secondaryDataRect().isNull());
+        QCOMPARE(renderer.backgroundColor(), QColor(Qt::black));
+        QCOMPARE(renderer.foregroundColor(), QColor(Qt::white));
+        QCOMPARE(renderer.gridColor(), QColor(Qt::gray));
+        QVERIFY(!renderer.isGridShown());
+        QVERIFY(!renderer.antialiasing());
+        QVERIFY(renderer.plotObjects().isEmpty());
+        QVERIFY(renderer.axis(KPlotRenderer::LeftAxis)->areTickLabelsShown());
+        QVERIFY(!renderer.axis(KPlotRenderer::TopAxis)->areTickLabelsShown());
+    }
+
+    void testPixRect()
+    {
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(400, 300));
+        // Tick labels are shown on the left and bottom axes
+        QCOMPARE(renderer.leftPadding(), 40);
+        QCOMPARE(renderer.bottomPadding(), 40);
+        QCOMPARE(renderer.rightPadding(), 20);
+        QCOMPARE(renderer.topPadding(), 20);
+        QCOMPARE(renderer.pixRect(), QRect(0, 0, 340, 240));
+
+        renderer.setLeftPadding(10);
+        QCOMPARE(renderer.pixRect(), QRect(0, 0, 370, 240));
+        renderer.setDefaultPaddings();
+        QCOMPARE(renderer.pixRect(), QRect(0, 0, 340, 240));
+
+        renderer.setLimits(0.0, 10.0, 0.0, 10.0);
+        QCOMPARE(renderer.mapToPixRect(QPointF(0.0, 0.0)), QPointF(0.0, 240.0));
+        QCOMPARE(renderer.mapToPixRect(QPointF(10.0, 10.0)), QPointF(340.0, 0.0));
+    }
+
+    void testObjectsNotOwned()
+    {
+        KPlotObject *object = createObject();
+        {
+            KPlotRenderer renderer;
+            renderer.addPlotObject(object);
+            renderer.addPlotObject(nullptr);
+            QCOMPARE(renderer.plotObjects().size(), 1);
+            renderer.removeAllPlotObjects();
+            QVERIFY(renderer.plotObjects().isEmpty());
+            renderer.addPlotObject(object);
+        }
+        // Still valid after the renderer is gone
+        QCOMPARE(object->points().size(), 21);
+        delete object;
+    }
+
+    void testToImage()
+    {
+        std::unique_ptr<KPlotObject> object(createObject());
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(200, 150));
+        renderer.setLimits(-1.0, 21.0, -1.0, 11.0);
+        renderer.setBackgroundColor(Qt::blue);
+        renderer.addPlotObject(object.get());
+
+        const QImage image = renderer.toImage();
+        QCOMPARE(image.size(), QSize(200, 150));
+        QCOMPARE(image.pixelColor(0, 0), QColor(Qt::blue));
+
+        // The line is drawn somewhere in the plot area
+        bool red = false;
+        for (int y = 0; y < image.height() && !red; ++y) {
+            for (int x = 0; x < image.width() && !red; ++x) {
+                red = image.pixelColor(x, y) == QColor(Qt::red);
+            }
+        }
+        QVERIFY(red);
+
+        const QImage hiDpi = renderer.toImage(2.0);
+        QCOMPARE(hiDpi.size(), QSize(400, 300));
+        QCOMPARE(hiDpi.devicePixelRatio(), 2.0);
+    }
+
+    void testMatchesWidget()
+    {
+        KPlotWidget widget;
+        widget.resize(300, 200);
+        widget.setLimits(-1.0, 21.0, -1.0, 11.0);
+        widget.setShowGrid(true);
+        widget.axis(KPlotWidget::BottomAxis)->setLabel(QStringLiteral("x"));
+        widget.addPlotObject(createObject());
+
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(300, 200));
+        renderer.setFont(widget.font());
+        renderer.setLimits(-1.0, 21.0, -1.0, 11.0);
+        renderer.setShowGrid(true);
+        renderer.axis(KPlotRenderer::BottomAxis)->setLabel(QStringLiteral("x"));
+        renderer.addPlotObjects(widget.plotObjects());
+
+        QImage expected(widget.size(), QImage::Format_RGB32);
+        widget.render(&expected);
+        QImage image(renderer.size(), QImage::Format_RGB32);
+        QPainter p(&image);
+        renderer.render(&p);
+        p.end();
+        QCOMPARE(image, expected);
+
+        renderer.removeAllPlotObjects();
+    }
+
+    void testDisplayList()
+    {
+        std::unique_ptr<KPlotObject> object(createObject());
+        object->setShowBars(true);
+        object->addPoint(21, 5, QStringLiteral("label"));
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(200, 150));
+        renderer.setLimits(-1.0, 22.0, -1.0, 11.0);
+        renderer.addPlotObject(object.get());
+
+        // repaints of the same view replay what was recorded
+        const QImage expected = renderer.toImage();
+        QCOMPARE(renderer.toImage(), expected);
+
+        // a change of the view records it again
+        renderer.setLimits(-1.0, 11.0, -1.0, 11.0);
+        QVERIFY(renderer.toImage() != expected);
+        renderer.setLimits(-1.0, 22.0, -1.0, 11.0);
+        QCOMPARE(renderer.toImage(), expected);
+
+        // and so do changes of the object
+        object->setPointStyle(KPlotObject::Square);
+        QVERIFY(renderer.toImage() != expected);
+        object->setPointStyle(KPlotObject::Circle);
+        QCOMPARE(renderer.toImage(), expected);
+        object->removePoint(3);
+        QVERIFY(renderer.toImage() != expected);
+    }
+
+    void testPointEdits()
+    {
+        std::unique_ptr<KPlotObject> object(createObject());
+        object->setShowBars(true);
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(200, 150));
+        renderer.setLimits(-1.0, 21.0, -1.0, 11.0);
+        renderer.addPlotObject(object.get());
+        const QImage before = renderer.toImage();
+
+        // points edited through their setters are drawn where they are now
+        object->points().at(5)->setY(10);
+        object->points().at(8)->setLabel(QStringLiteral("label"));
+        object->points().at(12)->setBarWidth(0.5);
+        const QImage image = renderer.toImage();
+        QVERIFY(image != before);
+
+        std::unique_ptr<KPlotObject> expected(new KPlotObject(Qt::red, KPlotObject::Lines));
+        expected->setShowPoints(true);
+        expected->setShowBars(true);
+        for (int i = 0; i <= 20; ++i) {
+            expected->addPoint(i, i == 5 ? 10 : (i * 7) % 11, i == 8 ? QStringLiteral("label") : QString(), i == 12 ? 0.5 : 0.0);
+        }
+        renderer.removeAllPlotObjects();
+        renderer.addPlotObject(expected.get());
+        QCOMPARE(image, renderer.toImage());
+    }
+
+    void testUniformSamples_data()
+    {
+        QTest::addColumn<int>("type");
+        QTest::addColumn<double>("x1");
+        QTest::addColumn<double>("x2");
+        QTest::addColumn<bool>("logX");
+
+        QTest::addRow("lines") << int(KPlotObject::Lines | KPlotObject::Points) << -1.0 << 21.0 << false;
+        QTest::addRow("zoomed") << int(KPlotObject::Lines | KPlotObject::Points) << 3.3 << 7.9 << false;
+        QTest::addRow("bars") << int(KPlotObject::Bars) << 2.5 << 15.5 << false;
+        QTest::addRow("log") << int(KPlotObject::Lines) << 0.5 << 30.0 << true;
+    }
+
+    void testUniformSamples()
+    {
+        QFETCH(int, type);
+        QFETCH(double, x1);
+        QFETCH(double, x2);
+        QFETCH(bool, logX);
+
+        // uniform samples look the same as the points they stand for
+        std::unique_ptr<KPlotObject> object(createObject());
+        object->setShowBars(type & KPlotObject::Bars);
+        object->setShowLines(type & KPlotObject::Lines);
+        object->setShowPoints(type & KPlotObject::Points);
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(200, 150));
+        renderer.setLimits(x1, x2, -1.0, 11.0);
+        renderer.setLogScale(Qt::Horizontal, logX);
+        renderer.addPlotObject(object.get());
+        const QImage expected = renderer.toImage();
+
+        QList<double> ys;
+        for (const KPlotPoint *p : object->points()) {
+            ys.append(p->y());
+        }
+        object->setUniformSamples(0.0, 1.0, ys);
+        QCOMPARE(renderer.toImage(), expected);
+        QVERIFY(object->isUniformlySampled());
+    }
+
+    void testDensePoints()
+    {
+        std::unique_ptr<KPlotObject> object(new KPlotObject(Qt::red, KPlotObject::Points, 4.0, KPlotObject::Star));
+        std::unique_ptr<KPlotObject> repeated(new KPlotObject(Qt::red, KPlotObject::Points, 4.0, KPlotObject::Star));
+        for (int i = 0; i < 2000; ++i) {
+            const double x = ((i * 61) % 997) * 0.01;
+            const double y = ((i * 89) % 991) * 0.01;
+            object->addPoint(x, y);
+            for (int j = 0; j < 3; ++j) {
+                repeated->addPoint(x, y);
+            }
+        }
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(200, 150));
+        renderer.setLimits(0.0, 10.0, 0.0, 10.0);
+        renderer.addPlotObject(object.get());
+        const QImage dots = renderer.toImage();
+
+        // Repeated points land on the same dots
+        renderer.removeAllPlotObjects();
+        renderer.addPlotObject(repeated.get());
+        QCOMPARE(renderer.toImage(), dots);
+
+        // Without a limit, the stars are drawn
+        renderer.removeAllPlotObjects();
+        renderer.addPlotObject(object.get());
+        object->setPointDensityLimit(0.0);
+        const QImage stars = renderer.toImage();
+        QVERIFY(stars != dots);
+
+        // The stars cover the plot area several times over, but not a
+        // thousand times
+        object->setPointDensityLimit(1000.0);
+        QCOMPARE(renderer.toImage(), stars);
+        object->setPointDensityLimit(1.0);
+        QCOMPARE(renderer.toImage(), dots);
+
+        // Small points are only dense by their own sizes
+        std::unique_ptr<KPlotObject> small(new KPlotObject(Qt::red, KPlotObject::Points, 0.5, KPlotObject::Star));
+        for (int i = 0; i < 2000; ++i) {
+            small->addPoint(((i * 61) % 997) * 0.01, ((i * 89) % 991) * 0.01);
+        }
+        renderer.removeAllPlotObjects();
+        renderer.addPlotObject(small.get());
+        small->setPointDensityLimit(0.01);
+        const QImage smallDots = renderer.toImage();
+        small->setPointDensityLimit(1.0);
+        QVERIFY(renderer.toImage() != smallDots);
+        small->setPointSizes(QList<double>(2000, 4.0));
+        QCOMPARE(renderer.toImage(), smallDots);
+
+        // Only the points inside the plot area count, also in y and for
+        // points not sorted by x
+        QVERIFY(!object->isSortedByX());
+        renderer.removeAllPlotObjects();
+        renderer.addPlotObject(object.get());
+        const QRectF views[] = {QRectF(0.0, 0.0, 1.0, 1.0), QRectF(0.0, 0.0, 10.0, 0.5)};
+        for (const QRectF &view : views) {
+            renderer.setLimits(view.left(), view.right(), view.top(), view.bottom());
+            object->setPointDensityLimit(0.0);
+            const QImage markers = renderer.toImage();
+            object->setPointDensityLimit(1.0);
+            QCOMPARE(renderer.toImage(), markers);
+        }
+    }
+
+    void testColoredPoints()
+    {
+        std::unique_ptr<KPlotObject> object(new KPlotObject(Qt::red, KPlotObject::Points));
+        std::unique_ptr<KPlotObject> low(new KPlotObject(Qt::blue, KPlotObject::Points, 3.0));
+        std::unique_ptr<KPlotObject> high(new KPlotObject(Qt::green, KPlotObject::Points, 3.0));
+        QList<double> values;
+        for (int i = 0; i < 10; ++i) {
+            object->addPoint(i, (i * 3) % 10);
+            values.append(0.1 * i);
+            (i < 5 ? low : high)->addPoint(i, (i * 3) % 10);
+        }
+        object->setPointValues(values);
+        object->setPointSizes(QList<double>(10, 3.0));
+        object->setColorTable({Qt::blue, Qt::green});
+
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(200, 150));
+        renderer.setLimits(-1.0, 10.0, -1.0, 10.0);
+        renderer.addPlotObject(object.get());
+        const QImage image = renderer.toImage();
+
+        // The same as one object per color
+        renderer.removeAllPlotObjects();
+        renderer.addPlotObject(low.get());
+        renderer.addPlotObject(high.get());
+        QCOMPARE(image, renderer.toImage());
+    }
+
+    void testPointsUnderPoint()
+    {
+        // Unsorted points, which cannot be narrowed down by their x
+        std::unique_ptr<KPlotObject> object(new KPlotObject(Qt::red, KPlotObject::Points));
+        for (int i = 0; i < 500; ++i) {
+            object->addPoint(((i * 37) % 101) * 0.1, ((i * 53) % 103) * 0.1);
+        }
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(200, 150));
+        renderer.setLimits(0.0, 10.0, 0.0, 10.0);
+        renderer.addPlotObject(object.get());
+        QCOMPARE(renderer.pickRadius(), 4);
+
+        auto check = [&] {
+            const QList<KPlotPoint *> points = object->points();
+            for (int y = 0; y <= renderer.pixRect().height(); y += 3) {
+                for (int x = 0; x <= renderer.pixRect().width(); x += 3) {
+                    const QPoint p(x, y);
+                    QList<KPlotPoint *> expected;
+                    KPlotPoint *nearest = nullptr;
+                    int nearestDistance = renderer.pickRadius() + 1;
+                    for (KPlotPoint *point : points) {
+                        const int distance = (p - renderer.mapToPixRect(point->position()).toPoint()).manhattanLength();
+                        if (distance <= renderer.pickRadius()) {
+                            expected << point;
+                        }
+                        if (distance < nearestDistance) {
+                            nearestDistance = distance;
+                            nearest = point;
+                        }
+                    }
+                    QCOMPARE(renderer.pointsUnderPoint(p), expected);
+                    QCOMPARE(renderer.nearestPoint(p), nearest);
+                }
+            }
+        };
+        check();
+        renderer.setPickRadius(10);
+        check();
+        renderer.setLimits(2.0, 5.0, 1.0, 4.0);
+        check();
+        object->removePoint(17);
+        check();
+
+        // Uniform samples only get points for the hits
+        std::unique_ptr<KPlotObject> samples(new KPlotObject(Qt::red, KPlotObject::Points));
+        QList<double> ys;
+        for (int i = 0; i < 1000; ++i) {
+            ys.append(((i * 53) % 103) * 0.1);
+        }
+        samples->setUniformSamples(0.0, 0.01, ys);
+        renderer.removeAllPlotObjects();
+        renderer.setLimits(0.0, 10.0, 0.0, 10.0);
+        renderer.addPlotObject(samples.get());
+        const QPoint p = renderer.mapToPixRect(QPointF(5.0, ys[500])).toPoint();
+        const QList<KPlotPoint *> hits = renderer.pointsUnderPoint(p);
+        QVERIFY(!hits.isEmpty());
+        QVERIFY(hits.contains(renderer.nearestPoint(p)));
+        QCOMPARE(renderer.pointsUnderPoint(p), hits);
+        QVERIFY(samples->isUniformlySampled());
+
+        // and they stay the same points once stored explicitly
+        object.swap(samples);
+        renderer.removeAllPlotObjects();
+        renderer.addPlotObject(object.get());
+        check();
+        QVERIFY(!object->isUniformlySampled());
+        QCOMPARE(renderer.pointsUnderPoint(p), hits);
+    }
+
+    void testWorkerThread()
+    {
+        std::unique_ptr<KPlotObject> object(createObject());
+        KPlotRenderer renderer;
+        renderer.setSize(QSize(200, 150));
+        renderer.setLimits(-1.0, 21.0, -1.0, 11.0);
+        renderer.addPlotObject(object.get());
+        const QImage expected = renderer.toImage();
+
+        // The object is only used by the thread while it runs
+        QImage image;
+        std::unique_ptr<QThread> thread(QThread::create([&] {
+            KPlotRenderer threadRenderer;
+            threadRenderer.setSize(QSize(200, 150));
+            threadRenderer.setLimits(-1.0, 21.0, -1.0, 11.0);
+            threadRenderer.addPlotObject(object.get());
+            image = threadRenderer.toImage();
+        }));
+        thread->start();
+        QVERIFY(thread->wait());
+        QCOMPARE(image, expected);
+    }
+};
+
+QTEST_MAIN(KPlotRendererTest)
+
+#include "kplotrenderertest.moc"
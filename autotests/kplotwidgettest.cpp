@@ -4,12 +4,42 @@
     SPDX-License-Identifier: LGPL-2.0-or-later
 */
 
+#include <kplotaxis.h>
 #include <kplotobject.h>
+#include <kplotpoint.h>
 #include <kplotwidget.h>
 
 #include <qtest_widgets.h>
 
 #include <QBrush>
+#include <QElapsedTimer>
+#include <QFont>
+#include <QLineF>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPen>
+#include <QResizeEvent>
+#include <QSignalSpy>
+#include <QWheelEvent>
+
+#include <math.h>
+
+#include <memory>
+
+class PaintRecordingPlotWidget : public KPlotWidget
+{
+public:
+    QRegion painted;
+    int paintCount = 0;
+
+protected:
+    void paintEvent(QPaintEvent *e) override
+    {
+        painted += e->region();
+        ++paintCount;
+        KPlotWidget::paintEvent(e);
+    }
+};
 
 class KPlotWidgetTest : public QObject
 {
@@ -78,6 +108,27 @@ private Q_SLOTS:
         QCOMPARE(widget->plotObjects().size(), 0);
     }
 
+    void testDeletedPlotObject()
+    {
+        widget->setAutoDeletePlotObjects(false);
+        KPlotWidget other;
+        other.setAutoDeletePlotObjects(false);
+
+        // an object deleted while it is shown leaves the widgets showing it
+        std::unique_ptr<KPlotObject> kept(new KPlotObject(Qt::red));
+        KPlotObject *object = new KPlotObject(Qt::green);
+        widget->addPlotObjects({kept.get(), object});
+        other.addPlotObject(object);
+        widget->grab();
+        delete object;
+        QCOMPARE(widget->plotObjects(), QList<KPlotObject *>() << kept.get());
+        QVERIFY(other.plotObjects().isEmpty());
+        widget->grab();
+
+        widget->removeAllPlotObjects();
+        QVERIFY(widget->plotObjects().isEmpty());
+    }
+
     void testReplacePlotObject()
     {
         QList<KPlotObject *> list;
@@ -137,6 +188,708 @@ private Q_SLOTS:
         QCOMPARE(widget->antialiasing(), false);
     }
 
+    void testLogScale()
+    {
+        widget->resize(400, 400);
+        QResizeEvent resize(widget->size(), QSize());
+        QCoreApplication::sendEvent(widget, &resize);
+
+        widget->setLimits(1.0, 1000.0, 0.0, 1.0);
+        QCOMPARE(widget->isLogScale(Qt::Horizontal), false);
+
+        widget->setLogScale(Qt::Horizontal, true);
+        QCOMPARE(widget->isLogScale(Qt::Horizontal), true);
+        QCOMPARE(widget->isLogScale(Qt::Vertical), false);
+        QVERIFY(widget->axis(KPlotWidget::BottomAxis)->isLogScale());
+        QVERIFY(widget->axis(KPlotWidget::TopAxis)->isLogScale());
+        QVERIFY(!widget->axis(KPlotWidget::LeftAxis)->isLogScale());
+        QCOMPARE(widget->axis(KPlotWidget::BottomAxis)->majorTickMarks(), QList<double>() << 1.0 << 10.0 << 100.0 << 1000.0);
+
+        // decades are equally spaced
+        const double x1 = widget->mapToWidget(QPointF(1.0, 0.5)).x();
+        const double x10 = widget->mapToWidget(QPointF(10.0, 0.5)).x();
+        const double x100 = widget->mapToWidget(QPointF(100.0, 0.5)).x();
+        QCOMPARE(x1, double(widget->pixRect().left()));
+        QVERIFY(x10 > x1);
+        QVERIFY(qAbs((x100 - x10) - (x10 - x1)) < 1e-6);
+
+        widget->setLogScale(Qt::Horizontal, false);
+        QCOMPARE(widget->axis(KPlotWidget::BottomAxis)->majorTickMarks().first(), 200.0);
+        QVERIFY(qAbs(widget->mapToWidget(QPointF(500.5, 0.5)).x() - widget->pixRect().center().x()) < 1.0);
+    }
+
+    void testMaskAlongLongLine()
+    {
+        widget->resize(400, 400);
+        QResizeEvent resize(widget->size(), QSize());
+        QCoreApplication::sendEvent(widget, &resize);
+        widget->setLimits(0.0, 100.0, 0.0, 100.0);
+
+        // The image of a label placed at the center after masking lines
+        auto placeLabel = [this](const QList<QLineF> &lines) {
+            widget->resetPlotMask();
+            for (const QLineF &line : lines) {
+                widget->maskAlongLine(line.p1(), line.p2(), 255.0f);
+            }
+            QImage image(widget->size(), QImage::Format_RGB32);
+            image.fill(Qt::white);
+            QPainter p(&image);
+            KPlotPoint point(50.0, 50.0, QStringLiteral("label"));
+            widget->placeLabel(&p, &point);
+            return image;
+        };
+
+        const QPointF c = widget->mapToWidget(QPointF(50.0, 50.0));
+        const QRect pixRect = widget->pixRect();
+        const QImage unmasked = placeLabel({});
+
+        // lines far outside of the plot must be clipped, not iterated over,
+        // and mask what their part inside the plot masks
+        const QImage longLines = placeLabel({QLineF(-1e9, c.y(), 1e9, c.y()), QLineF(c.x(), -1e9, c.x(), 1e9)});
+        const QImage shortLines = placeLabel({QLineF(pixRect.left() - 1, c.y(), pixRect.right() + 1, c.y()),
+                                              QLineF(c.x(), pixRect.top() - 1, c.x(), pixRect.bottom() + 1)});
+        QVERIFY(longLines != unmasked);
+        QCOMPARE(longLines, shortLines);
+
+        // and lines missing the plot mask nothing
+        QCOMPARE(placeLabel({QLineF(-1e9, -1e9, 1e9, -1e9 + 1.0), QLineF(-1e9, -10, 1e9, -10)}), unmasked);
+    }
+
+    void testAdaptiveAntialiasing()
+    {
+        widget->resize(300, 300);
+        widget->setLimits(0.0, 100.0, -1.0, 1.0);
+
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        for (int i = 0; i <= 100; ++i) {
+            object->addPoint(i, sin(i * 0.1));
+        }
+        widget->addPlotObject(object);
+
+        const QImage aliased = widget->grab().toImage();
+        widget->setAntialiasing(true);
+        const QImage antialiased = widget->grab().toImage();
+        QVERIFY(aliased != antialiased);
+
+        QCOMPARE(widget->adaptiveAntialiasing(), false);
+        QCOMPARE(widget->antialiasingDelay(), 250);
+        widget->setAdaptiveAntialiasing(true);
+        widget->setAntialiasingDelay(50);
+        QCOMPARE(widget->adaptiveAntialiasing(), true);
+        QCOMPARE(widget->antialiasingDelay(), 50);
+        QCOMPARE(widget->grab().toImage(), antialiased);
+
+        // changing the view draws aliased until it settles
+        widget->setLimits(0.0, 100.0, -1.0, 1.0);
+        QCOMPARE(widget->grab().toImage(), aliased);
+        QTRY_COMPARE(widget->grab().toImage(), antialiased);
+
+        // switching it off draws antialiased right away
+        widget->setLimits(0.0, 100.0, -1.0, 1.0);
+        widget->setAdaptiveAntialiasing(false);
+        QCOMPARE(widget->grab().toImage(), antialiased);
+
+        // cached layers stay antialiased while the view is changing, as
+        // long as they are up to date
+        widget->setAdaptiveAntialiasing(true);
+        widget->setObjectLayerCaching(true);
+        widget->setAxesCaching(true);
+        QCOMPARE(widget->grab().toImage(), antialiased);
+        widget->setLimits(0.0, 100.0, -1.0, 1.0);
+        QCOMPARE(widget->grab().toImage(), antialiased);
+
+        // a layer drawn again meanwhile is aliased until the view settles
+        object->setLinePen(QPen(Qt::blue, 1));
+        widget->setLimits(0.0, 100.0, -1.0, 1.0);
+        const QImage changed = widget->grab().toImage();
+        QVERIFY(changed != antialiased);
+        widget->setAdaptiveAntialiasing(false);
+        const QImage changedAntialiased = widget->grab().toImage();
+        QVERIFY(changed != changedAntialiased);
+        widget->setAdaptiveAntialiasing(true);
+        widget->setLimits(0.0, 100.0, -1.0, 1.0);
+        QTRY_COMPARE(widget->grab().toImage(), changedAntialiased);
+    }
+
+    void testNavigation()
+    {
+        widget->resize(300, 300);
+        widget->setLimits(0.0, 100.0, -1.0, 1.0);
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        for (int i = -100; i <= 200; ++i) {
+            object->addPoint(i, sin(i * 0.1));
+        }
+        widget->addPlotObject(object);
+        widget->show();
+        QVERIFY(QTest::qWaitForWindowExposed(widget));
+
+        QCOMPARE(widget->navigationModes(), KPlotWidget::NavigationModes(KPlotWidget::NoNavigation));
+        QCOMPARE(widget->navigationDelay(), 150);
+        widget->setNavigationModes(KPlotWidget::WheelZoom | KPlotWidget::DragPan | KPlotWidget::RubberBandZoom);
+        widget->setNavigationDelay(200);
+        QCOMPARE(widget->navigationDelay(), 200);
+        QSignalSpy spy(widget, &KPlotWidget::limitsChanged);
+
+        const QPoint origin(widget->leftPadding(), widget->topPadding());
+        const QRect plot = widget->pixRect().translated(origin);
+        auto dataAt = [&](const QPoint &p) {
+            const QRectF r = widget->dataRect();
+            const QRect pix = widget->pixRect();
+            return QPointF(r.left() + (p.x() - origin.x()) * r.width() / pix.width(), r.bottom() - (p.y() - origin.y()) * r.height() / pix.height());
+        };
+        auto near = [](const QPointF &a, const QPointF &b) {
+            return qAbs(a.x() - b.x()) < 1e-9 && qAbs(a.y() - b.y()) < 1e-9;
+        };
+
+        // Dragging moves the data under the cursor along with it
+        const QPoint start = plot.center();
+        const QPointF startData = dataAt(start);
+        QTest::mousePress(widget, Qt::LeftButton, Qt::NoModifier, start);
+        QTest::mouseMove(widget, start + QPoint(30, 20));
+        QTest::mouseRelease(widget, Qt::LeftButton, Qt::NoModifier, start + QPoint(30, 20));
+        const QImage preview = widget->grab().toImage();
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.last().at(0).toRectF(), widget->dataRect());
+        QVERIFY(near(dataAt(start + QPoint(30, 20)), startData));
+
+        // Until the view settles, the last rendering is moved along,
+        // without the data that was outside of it
+        KPlotWidget reference;
+        reference.setAutoDeletePlotObjects(false);
+        reference.resize(300, 300);
+        const QRectF limits = widget->dataRect();
+        reference.setLimits(limits.left(), limits.right(), limits.top(), limits.bottom());
+        reference.addPlotObject(object);
+        const QImage expected = reference.grab().toImage();
+        QVERIFY(preview != expected);
+        QTRY_COMPARE(widget->grab().toImage(), expected);
+
+        // The wheel zooms around the cursor
+        const double width = widget->dataRect().width();
+        QWheelEvent wheel(QPointF(start), QPointF(widget->mapToGlobal(start)), QPoint(), QPoint(0, 120), Qt::NoButton, Qt::NoModifier, Qt::NoScrollPhase, false);
+        QApplication::sendEvent(widget, &wheel);
+        QCOMPARE(spy.count(), 2);
+        QVERIFY(qAbs(widget->dataRect().width() - width / 1.2) < 1e-9);
+        QVERIFY(near(dataAt(start), startData));
+
+        // With panning also enabled, the rubber band needs Shift
+        const QPoint a = plot.topLeft() + QPoint(10, 10);
+        const QPoint b = a + QPoint(100, 50);
+        const QPointF dataA = dataAt(a);
+        const QPointF dataB = dataAt(b);
+        QTest::mousePress(widget, Qt::LeftButton, Qt::ShiftModifier, a);
+        QTest::mouseMove(widget, b);
+        QCOMPARE(spy.count(), 2);
+        QTest::mouseRelease(widget, Qt::LeftButton, Qt::ShiftModifier, b);
+        QCOMPARE(spy.count(), 3);
+        QVERIFY(near(widget->dataRect().topLeft(), QPointF(dataA.x(), dataB.y())));
+        QVERIFY(near(widget->dataRect().bottomRight(), QPointF(dataB.x(), dataA.y())));
+
+        // A click without moving leaves the plot showing changes
+        QTest::mousePress(widget, Qt::LeftButton, Qt::NoModifier, start);
+        QTest::mouseRelease(widget, Qt::LeftButton, Qt::NoModifier, start);
+        QCOMPARE(spy.count(), 3);
+        object->setLinePen(QPen(Qt::blue, 1));
+        const QRectF zoomed = widget->dataRect();
+        reference.setLimits(zoomed.left(), zoomed.right(), zoomed.top(), zoomed.bottom());
+        QCOMPARE(widget->grab().toImage(), reference.grab().toImage());
+    }
+
+    void testObjectLayerCaching()
+    {
+        widget->resize(300, 300);
+        widget->setLimits(0.0, 10.0, 0.0, 10.0);
+
+        KPlotObject *lines = new KPlotObject(Qt::red, KPlotObject::Lines);
+        KPlotObject *points = new KPlotObject(Qt::green, KPlotObject::Points, 3, KPlotObject::Square);
+        for (int i = 0; i <= 10; ++i) {
+            lines->addPoint(i, (i * i) % 10);
+            points->addPoint(i, (i * 3) % 10);
+        }
+        widget->addPlotObject(lines);
+        widget->addPlotObject(points);
+
+        const QImage direct = widget->grab().toImage();
+
+        QCOMPARE(widget->objectLayerCaching(), false);
+        widget->setObjectLayerCaching(true);
+        QCOMPARE(widget->objectLayerCaching(), true);
+
+        const QImage cached = widget->grab().toImage();
+        QCOMPARE(cached, direct);
+
+        // a change of an object invalidates its layer
+        lines->setLinePen(QPen(Qt::blue, 1));
+        const QImage changed = widget->grab().toImage();
+        QVERIFY(changed != cached);
+
+        widget->setObjectLayerCaching(false);
+        QCOMPARE(widget->grab().toImage(), changed);
+    }
+
+    void testParallelRendering()
+    {
+        widget->resize(400, 300);
+        widget->setLimits(0.0, 1000.0, -1.0, 1.0);
+        // the tiles are drawn with the widget font
+        QFont font = widget->font();
+        font.setPointSize(18);
+        widget->setFont(font);
+
+        KPlotObject *lines = new KPlotObject(Qt::red, KPlotObject::Lines);
+        KPlotObject *points = new KPlotObject(Qt::green, KPlotObject::Points, 3, KPlotObject::Circle);
+        for (int i = 0; i <= 1000; ++i) {
+            lines->addPoint(i, sin(i * 0.05));
+            points->addPoint(i, cos(i * 0.07));
+        }
+        // drawn whole between the tiled objects
+        KPlotObject *unsorted = new KPlotObject(Qt::blue, KPlotObject::Lines);
+        for (int i = 0; i <= 1000; ++i) {
+            unsorted->addPoint((i * 397) % 1001, 0.5 * sin(i * 0.3));
+        }
+        widget->addPlotObject(lines);
+        widget->addPlotObject(unsorted);
+        widget->addPlotObject(points);
+
+        const QImage serial = widget->grab().toImage();
+
+        QCOMPARE(widget->parallelRendering(), false);
+        widget->setParallelRendering(true);
+        QCOMPARE(widget->parallelRendering(), true);
+        QCOMPARE(widget->grab().toImage(), serial);
+
+        // also for the object layers
+        widget->setObjectLayerCaching(true);
+        QCOMPARE(widget->grab().toImage(), serial);
+
+        // markers larger than size() reach into the neighbouring tiles
+        widget->setObjectLayerCaching(false);
+        points->setPointSizes(QList<double>(1001, 25.0));
+        points->setPointDensityLimit(0.0);
+        widget->setParallelRendering(false);
+        const QImage large = widget->grab().toImage();
+        widget->setParallelRendering(true);
+        QCOMPARE(widget->grab().toImage(), large);
+    }
+
+    void testAsyncRendering()
+    {
+        widget->resize(300, 300);
+        widget->setLimits(0.0, 100.0, -1.0, 1.0);
+
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        for (int i = 0; i <= 100; ++i) {
+            object->addPoint(i, sin(i * 0.1));
+        }
+        widget->addPlotObject(object);
+
+        const QImage direct = widget->grab().toImage();
+
+        QCOMPARE(widget->asyncRendering(), false);
+        widget->setAsyncRendering(true);
+        QCOMPARE(widget->asyncRendering(), true);
+
+        // the first repaint only starts the rendering; the frame is
+        // shown once it is ready
+        widget->grab();
+        QTRY_COMPARE(widget->grab().toImage(), direct);
+
+        // changes are picked up by the next frame
+        object->setLinePen(QPen(Qt::blue, 1));
+        widget->grab();
+        QTRY_VERIFY(widget->grab().toImage() != direct);
+    }
+
+    void testAsyncRenderingWhileStreaming()
+    {
+        widget->resize(300, 300);
+        widget->setLimits(0.0, 100.0, -1.0, 1.0);
+
+        // slow enough to render that points arrive during each frame
+        KPlotObject *lines = new KPlotObject(Qt::red, KPlotObject::Lines);
+        for (int i = 0; i <= 200000; ++i) {
+            lines->addPoint(i * 0.0005, sin(i * 0.001));
+        }
+        KPlotObject *bars = new KPlotObject(Qt::green, KPlotObject::Bars);
+        bars->addPoint(10.0, 0.5, QStringLiteral("first"), 4.0);
+        widget->addPlotObject(lines);
+        widget->addPlotObject(bars);
+        widget->setAsyncRendering(true);
+        const QImage empty = widget->grab().toImage();
+
+        // every repaint sees new points, and frames are still shown
+        QElapsedTimer timer;
+        timer.start();
+        int i = 0;
+        bool shown = false;
+        while (!shown && timer.elapsed() < 5000) {
+            bars->addPoint(20.0 + (i++ % 70), -0.5, QString(), 0.5);
+            shown = widget->grab().toImage() != empty;
+            QCoreApplication::processEvents();
+        }
+        QVERIFY(shown);
+
+        // and the last frame matches the direct rendering
+        widget->setAsyncRendering(false);
+        const QImage direct = widget->grab().toImage();
+        widget->setAsyncRendering(true);
+        widget->grab();
+        QTRY_COMPARE(widget->grab().toImage(), direct);
+    }
+
+    void testProgressiveRendering()
+    {
+        widget->resize(400, 300);
+        widget->setLimits(0.0, 10000.0, -1.0, 1.0);
+        // the strips are drawn with the widget font
+        QFont font = widget->font();
+        font.setPointSize(18);
+        widget->setFont(font);
+
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        for (int i = 0; i <= 10000; ++i) {
+            object->addPoint(i, sin(i * 0.01));
+        }
+        widget->addPlotObject(object);
+
+        const QImage serial = widget->grab().toImage();
+
+        QCOMPARE(widget->progressiveRendering(), false);
+        QCOMPARE(widget->frameBudget(), 16);
+        widget->setProgressiveRendering(true);
+        widget->setFrameBudget(0);
+        QCOMPARE(widget->progressiveRendering(), true);
+        QCOMPARE(widget->frameBudget(), 0);
+
+        // with no budget, each repaint refines one strip until the frame
+        // is complete
+        QSignalSpy spy(widget, &KPlotWidget::frameCompleted);
+        QImage image;
+        for (int i = 0; i < 100 && spy.isEmpty(); ++i) {
+            image = widget->grab().toImage();
+            QCoreApplication::processEvents();
+        }
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(image, serial);
+
+        // the complete frame is reused
+        QCOMPARE(widget->grab().toImage(), serial);
+        QCoreApplication::processEvents();
+        QCOMPARE(spy.count(), 1);
+
+        // objects not sorted by x are rendered in full at once
+        KPlotObject *unsorted = new KPlotObject(Qt::blue, KPlotObject::Lines);
+        for (int i = 0; i <= 10000; ++i) {
+            unsorted->addPoint((i * 397) % 10001, 0.5 * sin(i * 0.3));
+        }
+        widget->addPlotObject(unsorted);
+        widget->setProgressiveRendering(false);
+        const QImage full = widget->grab().toImage();
+        widget->setProgressiveRendering(true);
+        QCOMPARE(widget->grab().toImage(), full);
+    }
+
+    void testStripChartMode()
+    {
+        widget->resize(300, 300);
+        widget->setLeftPadding(20);
+        widget->setRightPadding(20);
+        widget->setTopPadding(20);
+        widget->setBottomPadding(20);
+        // two pixels per unit along x, so that shifting the limits by
+        // whole units scrolls by whole pixels
+        widget->setLimits(0.0, 130.0, 0.0, 10.0);
+
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines, 2, KPlotObject::Square);
+        object->setShowPoints(true);
+        for (int i = 0; i <= 130; ++i) {
+            object->addPoint(i, (i * 7) % 10);
+        }
+        widget->addPlotObject(object);
+
+        QCOMPARE(widget->stripChartMode(), false);
+        widget->setStripChartMode(true);
+        QCOMPARE(widget->stripChartMode(), true);
+        widget->grab();
+
+        for (int i = 131; i <= 140; ++i) {
+            object->addPoint(i, (i * 7) % 10);
+        }
+        widget->setLimits(10.0, 140.0, 0.0, 10.0);
+        const QImage scrolled = widget->grab().toImage();
+
+        // the scrolled layer matches a complete rendering
+        widget->setStripChartMode(false);
+        QCOMPARE(widget->grab().toImage(), scrolled);
+
+        // a shift by a pixel and a half is scrolled by two pixels, and the
+        // layer is then up to date for the unchanged view
+        widget->setStripChartMode(true);
+        widget->grab();
+        widget->setLimits(10.75, 140.75, 0.0, 10.0);
+        const QImage shifted = widget->grab().toImage();
+        QCOMPARE(widget->grab().toImage(), shifted);
+        QCOMPARE(widget->grab().toImage(), shifted);
+
+        // the half pixel left over is made up by the next shift
+        widget->setLimits(11.0, 141.0, 0.0, 10.0);
+        const QImage caughtUp = widget->grab().toImage();
+        widget->setStripChartMode(false);
+        QCOMPARE(widget->grab().toImage(), caughtUp);
+    }
+
+    void testObjectChangeUpdatesArea()
+    {
+        PaintRecordingPlotWidget w;
+        w.resize(400, 400);
+        w.setLimits(0.0, 100.0, 0.0, 100.0);
+
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        object->addPoint(10, 10);
+        object->addPoint(20, 20);
+        w.addPlotObject(object);
+        w.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&w));
+        QCoreApplication::processEvents();
+
+        // appending a point repaints the new segment only
+        w.painted = QRegion();
+        object->addPoint(30, 30);
+        QTRY_VERIFY(!w.painted.isEmpty());
+        const QRect r = w.painted.boundingRect();
+        QVERIFY(r.width() < w.width() / 4);
+        QVERIFY(r.height() < w.height() / 4);
+
+        // a style change repaints the object
+        w.painted = QRegion();
+        object->setLinePen(QPen(Qt::blue, 1));
+        QTRY_VERIFY(!w.painted.isEmpty());
+        QVERIFY(w.painted.boundingRect().width() < w.width() / 2);
+        const QPointF padding(w.leftPadding(), w.topPadding());
+        QVERIFY(w.painted.contains((w.mapToWidget(QPointF(10, 10)) + padding).toPoint()));
+        QVERIFY(w.painted.contains((w.mapToWidget(QPointF(30, 30)) + padding).toPoint()));
+
+        // also on log axes, mapped from the extents
+        w.setLimits(1.0, 100.0, 1.0, 100.0);
+        w.setLogScale(Qt::Horizontal, true);
+        QCoreApplication::processEvents();
+        w.painted = QRegion();
+        object->setLinePen(QPen(Qt::red, 1));
+        QTRY_VERIFY(!w.painted.isEmpty());
+        QVERIFY(w.painted.contains((w.mapToWidget(QPointF(10, 10)) + padding).toPoint()));
+        QVERIFY(w.painted.contains((w.mapToWidget(QPointF(30, 30)) + padding).toPoint()));
+        w.setLogScale(Qt::Horizontal, false);
+        w.setLimits(0.0, 100.0, 0.0, 100.0);
+
+        // markers larger than size() by their own sizes are repainted whole
+        KPlotObject *large = new KPlotObject(Qt::green, KPlotObject::Points, 2.0, KPlotObject::Square);
+        large->setPointSizes({30.0, 30.0});
+        large->addPoint(50, 50);
+        w.addPlotObject(large);
+        QCoreApplication::processEvents();
+        w.painted = QRegion();
+        large->addPoint(60, 50);
+        QTRY_VERIFY(!w.painted.isEmpty());
+        QVERIFY(w.painted.boundingRect().height() >= 60);
+    }
+
+    void testMaximumFrameRate()
+    {
+        PaintRecordingPlotWidget w;
+        QCOMPARE(w.maximumFrameRate(), 0);
+        w.setMaximumFrameRate(5);
+        QCOMPARE(w.maximumFrameRate(), 5);
+        w.resize(400, 400);
+        w.setLimits(0.0, 100.0, 0.0, 100.0);
+
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        object->addPoint(0, 0);
+        w.addPlotObject(object);
+        w.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&w));
+        QCoreApplication::processEvents();
+
+        // a burst of changes is painted in a frame or two
+        w.paintCount = 0;
+        w.painted = QRegion();
+        const qint64 merged = w.mergedUpdateCount();
+        for (int i = 1; i <= 50; ++i) {
+            object->addPoint(i, i);
+            QCoreApplication::processEvents();
+        }
+        QVERIFY(w.mergedUpdateCount() > merged);
+        QVERIFY(w.paintCount <= 2);
+
+        // and the last change is painted when the next frame is due
+        const QPointF last = w.mapToWidget(QPointF(50, 50)) + QPointF(w.leftPadding(), w.topPadding());
+        QTRY_VERIFY(w.painted.contains(last.toPoint()));
+
+        w.setMaximumFrameRate(0);
+        QCOMPARE(w.maximumFrameRate(), 0);
+    }
+
+    void testBatchUpdate()
+    {
+        PaintRecordingPlotWidget w;
+        w.resize(400, 400);
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        object->addPoint(0, 0);
+        w.addPlotObject(object);
+        w.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&w));
+        QCoreApplication::processEvents();
+
+        // nothing is repainted or recomputed until the outermost batch ends
+        const QList<double> ticks = w.axis(KPlotWidget::BottomAxis)->majorTickMarks();
+        w.paintCount = 0;
+        w.beginUpdate();
+        w.beginUpdate();
+        QVERIFY(w.isUpdating());
+        w.setLimits(0.0, 100.0, 0.0, 100.0);
+        w.setBackgroundColor(Qt::darkGreen);
+        w.addPlotObject(new KPlotObject(Qt::blue, KPlotObject::Points));
+        w.endUpdate();
+        QVERIFY(w.isUpdating());
+        QCoreApplication::processEvents();
+        QCOMPARE(w.paintCount, 0);
+        QCOMPARE(w.axis(KPlotWidget::BottomAxis)->majorTickMarks(), ticks);
+        w.endUpdate();
+        QVERIFY(!w.isUpdating());
+        QVERIFY(w.axis(KPlotWidget::BottomAxis)->majorTickMarks() != ticks);
+        QTRY_VERIFY(w.paintCount > 0);
+
+        // the same holds for the changes of an object
+        w.paintCount = 0;
+        object->beginUpdate();
+        QVERIFY(object->isUpdating());
+        for (int i = 1; i <= 50; ++i) {
+            object->addPoint(i, i);
+        }
+        object->setLinePen(QPen(Qt::yellow, 1));
+        QCoreApplication::processEvents();
+        QCOMPARE(w.paintCount, 0);
+        object->endUpdate();
+        QVERIFY(!object->isUpdating());
+        QTRY_VERIFY(w.paintCount > 0);
+
+        // the result is the same as without a batch
+        KPlotWidget reference;
+        reference.resize(400, 400);
+        reference.setLimits(0.0, 100.0, 0.0, 100.0);
+        reference.setBackgroundColor(Qt::darkGreen);
+        KPlotObject *copy = new KPlotObject(Qt::red, KPlotObject::Lines);
+        for (int i = 0; i <= 50; ++i) {
+            copy->addPoint(i, i);
+        }
+        copy->setLinePen(QPen(Qt::yellow, 1));
+        reference.addPlotObject(copy);
+        reference.addPlotObject(new KPlotObject(Qt::blue, KPlotObject::Points));
+        QCOMPARE(w.grab().toImage(), reference.grab().toImage());
+    }
+
+    void testAutoScaling()
+    {
+        QVERIFY(!widget->autoScaling());
+        QCOMPARE(widget->autoScalePadding(), 0.05);
+        QCOMPARE(widget->autoScaleHysteresis(), 0.1);
+        QSignalSpy spy(widget, &KPlotWidget::limitsChanged);
+
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        object->addPoint(0, 0);
+        object->addPoint(10, 5);
+        widget->addPlotObject(object);
+        QCOMPARE(widget->dataRect(), QRectF(0, 0, 1, 1));
+
+        // the limits leave the padding and half the hysteresis around the data
+        widget->setAutoScaling(true);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(widget->dataRect(), QRectF(QPointF(-1.5, -0.75), QPointF(11.5, 5.75)));
+
+        // data growing a little stays within them
+        object->addPoint(10.5, 2);
+        QCOMPARE(spy.count(), 1);
+
+        // data leaving them rescales the plot
+        object->addPoint(20, 5);
+        QCOMPARE(spy.count(), 2);
+        QCOMPARE(widget->dataRect(), QRectF(QPointF(-3, -0.75), QPointF(23, 5.75)));
+
+        // and so does data shrinking
+        object->clearPoints();
+        object->addPoint(0, 0);
+        object->addPoint(1, 1);
+        QCOMPARE(widget->dataRect(), QRectF(QPointF(-0.15, -0.15), QPointF(1.15, 1.15)));
+
+        // without padding and hysteresis the limits fit the data
+        widget->setAutoScalePadding(0.0);
+        widget->setAutoScaleHysteresis(0.0);
+        QCOMPARE(widget->dataRect(), QRectF(0, 0, 1, 1));
+        const int count = spy.count();
+        object->addPoint(0.5, 0.5);
+        QCOMPARE(spy.count(), count);
+
+        widget->setAutoScaling(false);
+        object->addPoint(5, 5);
+        QCOMPARE(widget->dataRect(), QRectF(0, 0, 1, 1));
+    }
+
+    void testSampleQueue()
+    {
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        object->setSampleQueueCapacity(64);
+        widget->setLimits(0.0, 10.0, 0.0, 10.0);
+        widget->addPlotObject(object);
+
+        // the widget takes the queued samples as points by itself
+        for (int i = 0; i < 10; ++i) {
+            QVERIFY(object->pushSample(i, i));
+        }
+        QTRY_COMPARE(object->points().size(), 10);
+        QVERIFY(object->pushSample(10, 10));
+        QTRY_COMPARE(object->points().size(), 11);
+    }
+
+    void testAxesCaching()
+    {
+        widget->resize(300, 300);
+        widget->setLimits(0.0, 10.0, 0.0, 10.0);
+        widget->setShowGrid(true);
+        widget->axis(KPlotWidget::LeftAxis)->setLabel(QStringLiteral("y"));
+        widget->axis(KPlotWidget::BottomAxis)->setLabel(QStringLiteral("x"));
+        QVERIFY(widget->axis(KPlotWidget::BottomAxis)->areTickLabelsShown());
+        KPlotObject *object = new KPlotObject(Qt::red, KPlotObject::Lines);
+        object->addPoint(0, 0);
+        object->addPoint(10, 10);
+        widget->addPlotObject(object);
+
+        const QImage direct = widget->grab().toImage();
+
+        QCOMPARE(widget->axesCaching(), false);
+        widget->setAxesCaching(true);
+        QCOMPARE(widget->axesCaching(), true);
+
+        const QImage cached = widget->grab().toImage();
+        QCOMPARE(cached, direct);
+
+        // new limits move the ticks and grid lines
+        widget->setLimits(0.0, 7.0, 0.0, 7.0);
+        const QImage changed = widget->grab().toImage();
+        QVERIFY(changed != cached);
+
+        // so does a change made through the axis
+        widget->axis(KPlotWidget::BottomAxis)->setVisible(false);
+        const QImage hidden = widget->grab().toImage();
+        QVERIFY(hidden != changed);
+
+        // and a new background, which the paddings of the layer are filled with
+        widget->setBackgroundColor(Qt::darkBlue);
+        const QImage background = widget->grab().toImage();
+        QVERIFY(background != hidden);
+
+        widget->setAxesCaching(false);
+        QCOMPARE(widget->grab().toImage(), background);
+    }
+
 private:
     KPlotWidget *widget;
 };
@@ -16,6 +16,7 @@ public:
         : q(qq)
         , m_visible(true)
         , m_showTickLabels(false)
+        , m_logScale(false)
         , m_labelFmt('g')
         , m_labelFieldWidth(0)
         , m_labelPrec(-1)
@@ -26,6 +27,7 @@ public:
 
     bool m_visible : 1; // Property "visible" defines if Axis is drawn or not.
     bool m_showTickLabels : 1;
+    bool m_logScale : 1; // Ticks are placed at decades
     char m_labelFmt; // Number format for number labels, see QString::arg()
     QString m_label; // The label of the axis.
     int m_labelFieldWidth; // Field width for number labels, see QString::arg()
@@ -93,11 +95,60 @@ int KPlotAxis::tickLabelPrecision() const
     return d->m_labelPrec;
 }
 
+bool KPlotAxis::isLogScale() const
+{
+    return d->m_logScale;
+}
+
+void KPlotAxis::setLogScale(bool b)
+{
+    d->m_logScale = b;
+}
+
 void KPlotAxis::setTickMarks(double x0, double length)
 {
     d->m_MajorTickMarks.clear();
     d->m_MinorTickMarks.clear();
 
+    if (d->m_logScale && x0 > 0.0) {
+        const double x1 = x0 + length;
+        const int firstDecade = int(floor(log10(x0)));
+        const int lastDecade = int(ceil(log10(x1)));
+
+        // With many decades, only every decadeStep-th decade gets a major
+        // tickmark, and the others get a minor one.
+        const int decadeStep = qMax(1, (lastDecade - firstDecade + 7) / 8);
+
+        for (int k = firstDecade; k <= lastDecade; ++k) {
+            const double decade = pow(10.0, k);
+            const bool isMajor = (k - firstDecade) % decadeStep == 0;
+            if (decade >= x0 && decade <= x1) {
+                if (isMajor) {
+                    d->m_MajorTickMarks.append(decade);
+                } else {
+                    d->m_MinorTickMarks.append(decade);
+                }
+            }
+
+            if (decadeStep == 1) {
+                for (int j = 2; j < 10; j++) {
+                    double xmin = j * decade;
+                    if (xmin >= x0 && xmin <= x1) {
+                        d->m_MinorTickMarks.append(xmin);
+                    }
+                }
+            }
+        }
+
+        // A range within about one decade has too few decades to label;
+        // it is then ticked like a linear one
+        if (d->m_MajorTickMarks.size() >= 2) {
+            return;
+        }
+        d->m_MajorTickMarks.clear();
+        d->m_MinorTickMarks.clear();
+    }
+
     // s is the power-of-ten factor of length:
     // length = t * s; s = 10^(pwr).  e.g., length=350.0 then t=3.5, s = 100.0; pwr = 2.0
     double pwr = 0.0;
@@ -120,6 +120,31 @@ public:
      */
     int tickLabelPrecision() const;
 
+    /*!
+     * Returns whether this axis uses a logarithmic scale
+     *
+     * \sa setLogScale()
+     * \since 6.28
+     */
+    bool isLogScale() const;
+
+    /*!
+     * Determine whether this axis uses a logarithmic (base 10) scale.
+     *
+     * On a logarithmic axis, setTickMarks() places major tickmarks at the
+     * decades and minor tickmarks at the integer multiples in between.
+     * Ranges that contain fewer than two decades get the tickmarks of a
+     * linear axis instead, so that they are still labeled.
+     *
+     * \note this is set by KPlotWidget::setLogScale(); you should not
+     * normally need to call it directly.
+     *
+     * \a b if true, the axis is logarithmic.
+     *
+     * \since 6.28
+     */
+    void setLogScale(bool b);
+
     /*!
      * Determine the positions of major and minor tickmarks for this axis.
      *
@@ -130,6 +155,9 @@ public:
      *
      * \a length the range covered by the axis, in data units.
      *
+     * \note on a logarithmic axis, \a x0 must be positive for decade
+     * tickmarks to be generated.
+     *
      * \sa majorTickMarks()
      * \sa minorTickMarks()
      */
@@ -0,0 +1,367 @@
+/*
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+/*
+ * kplotexport renders plot specs to PNG images, on all cores and without
+ * a windowing system.
+ *
+ * A plot spec is an INI file.  Colors are color names, or #rrggbb in
+ * quotes; file names are relative to the spec.
+ *
+ *   [Plot]
+ *   Output=temperature.png      ; default: the spec file name with .png
+ *   Size=800,600
+ *   Limits=0,24,-10,35          ; x1,x2,y1,y2; default: the data bounds
+ *   SecondaryLimits=32,75,14,95
+ *   LogX=false
+ *   LogY=false
+ *   Background=black
+ *   Foreground=white
+ *   GridColor=gray
+ *   Grid=true
+ *   Antialiasing=true
+ *   LeftLabel=Temperature
+ *   BottomLabel=Hour
+ *
+ *   [Object1]                   ; one group per object, drawn in name order
+ *   Data=temperature.dat        ; "x y [label]" per line, # starts a comment
+ *   Type=Points,Lines           ; any of Points, Lines and Bars
+ *   Color=red
+ *   Size=2
+ *   PointStyle=Circle
+ *   LineWidth=1
+ */
+
+#include <kplotaxis.h>
+#include <kplotobject.h>
+#include <kplotrenderer.h>
+#include <kplotting_version.h>
+
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QMutex>
+#include <QPen>
+#include <QSettings>
+#include <QTextStream>
+#include <QThreadPool>
+
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+struct DataBounds {
+    double x1 = qInf();
+    double x2 = -qInf();
+    double y1 = qInf();
+    double y2 = -qInf();
+
+    void add(double x, double y)
+    {
+        // nan or inf in the data would make the limits unusable
+        if (!qIsFinite(x) || !qIsFinite(y)) {
+            return;
+        }
+        x1 = qMin(x1, x);
+        x2 = qMax(x2, x);
+        y1 = qMin(y1, y);
+        y2 = qMax(y2, y);
+    }
+
+    bool isEmpty() const
+    {
+        return x1 > x2;
+    }
+};
+
+// Parse a comma-separated list of count numbers
+bool parseNumbers(const QVariant &value, int count, double *numbers)
+{
+    const QStringList fields = value.toStringList();
+    if (fields.size() != count) {
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        bool ok;
+        numbers[i] = fields.at(i).trimmed().toDouble(&ok);
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+KPlotObject::PointStyle parsePointStyle(const QString &name)
+{
+    static const char *const names[] = {"NoPoints", "Circle", "Letter", "Triangle", "Square", "Pentagon", "Hexagon", "Asterisk", "Star"};
+    for (int i = 0; i < int(std::size(names)); ++i) {
+        if (name.compare(QLatin1String(names[i]), Qt::CaseInsensitive) == 0) {
+            return KPlotObject::PointStyle(i);
+        }
+    }
+    return KPlotObject::UnknownPoint;
+}
+
+bool loadData(const QString &fileName, KPlotObject *object, DataBounds *bounds, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        *error = QStringLiteral("cannot open %1: %2").arg(fileName, file.errorString());
+        return false;
+    }
+
+    QTextStream in(&file);
+    QString line;
+    int lineNumber = 0;
+    while (in.readLineInto(&line)) {
+        ++lineNumber;
+        const QString text = line.simplified();
+        if (text.isEmpty() || text.startsWith(QLatin1Char('#'))) {
+            continue;
+        }
+        const QStringList fields = text.split(QLatin1Char(' '));
+        bool okX = false;
+        bool okY = false;
+        const double x = fields.at(0).toDouble(&okX);
+        const double y = fields.size() > 1 ? fields.at(1).toDouble(&okY) : 0.0;
+        if (!okX || !okY) {
+            *error = QStringLiteral("%1:%2: expected \"x y [label]\"").arg(fileName).arg(lineNumber);
+            return false;
+        }
+        object->addPoint(x, y, fields.mid(2).join(QLatin1Char(' ')));
+        bounds->add(x, y);
+    }
+    return true;
+}
+
+// Render the plot described by specFile, and save it as a PNG image
+bool renderSpec(const QString &specFile, const QString &outputDir, qreal scale, QString *error)
+{
+    const QFileInfo info(specFile);
+    if (!info.isFile()) {
+        *error = QStringLiteral("%1: no such file").arg(specFile);
+        return false;
+    }
+    const QDir dir = info.absoluteDir();
+    QSettings spec(info.absoluteFilePath(), QSettings::IniFormat);
+    if (spec.status() != QSettings::NoError) {
+        *error = QStringLiteral("%1: invalid spec").arg(specFile);
+        return false;
+    }
+
+    // The plot objects, drawn in the order of their group names
+    std::vector<std::unique_ptr<KPlotObject>> objects;
+    DataBounds bounds;
+    QStringList groups = spec.childGroups();
+    groups.sort();
+    for (const QString &group : std::as_const(groups)) {
+        if (!group.startsWith(QLatin1String("Object"))) {
+            continue;
+        }
+        spec.beginGroup(group);
+        const QColor color(spec.value(QStringLiteral("Color"), QStringLiteral("white")).toString());
+        const double size = spec.value(QStringLiteral("Size"), 2.0).toDouble();
+        const KPlotObject::PointStyle pointStyle = parsePointStyle(spec.value(QStringLiteral("PointStyle"), QStringLiteral("Circle")).toString());
+        const QStringList types = spec.value(QStringLiteral("Type"), QStringLiteral("Points")).toStringList();
+        const QString data = spec.value(QStringLiteral("Data")).toString();
+        const double lineWidth = spec.value(QStringLiteral("LineWidth"), 1.0).toDouble();
+        spec.endGroup();
+
+        if (!color.isValid() || pointStyle == KPlotObject::UnknownPoint || data.isEmpty()) {
+            *error = QStringLiteral("%1: invalid color, point style or data in [%2]").arg(specFile, group);
+            return false;
+        }
+
+        auto object = std::make_unique<KPlotObject>(color, KPlotObject::UnknownType, size, pointStyle);
+        object->setShowPoints(types.contains(QLatin1String("Points"), Qt::CaseInsensitive));
+        object->setShowLines(types.contains(QLatin1String("Lines"), Qt::CaseInsensitive));
+        object->setShowBars(types.contains(QLatin1String("Bars"), Qt::CaseInsensitive));
+        object->setLinePen(QPen(color, lineWidth));
+        if (!loadData(dir.absoluteFilePath(data), object.get(), &bounds, error)) {
+            return false;
+        }
+        objects.push_back(std::move(object));
+    }
+
+    KPlotRenderer renderer;
+    spec.beginGroup(QStringLiteral("Plot"));
+
+    double size[2] = {640, 480};
+    if (spec.contains(QStringLiteral("Size")) && (!parseNumbers(spec.value(QStringLiteral("Size")), 2, size) || size[0] < 1 || size[1] < 1)) {
+        *error = QStringLiteral("%1: invalid Size").arg(specFile);
+        return false;
+    }
+    renderer.setSize(QSize(int(size[0]), int(size[1])));
+
+    double limits[4] = {0.0, 1.0, 0.0, 1.0};
+    if (spec.contains(QStringLiteral("Limits"))) {
+        if (!parseNumbers(spec.value(QStringLiteral("Limits")), 4, limits)) {
+            *error = QStringLiteral("%1: invalid Limits").arg(specFile);
+            return false;
+        }
+    } else if (!bounds.isEmpty()) {
+        limits[0] = bounds.x1;
+        limits[1] = bounds.x2;
+        limits[2] = bounds.y1;
+        limits[3] = bounds.y2;
+    }
+    renderer.setLogScale(Qt::Horizontal, spec.value(QStringLiteral("LogX"), false).toBool());
+    renderer.setLogScale(Qt::Vertical, spec.value(QStringLiteral("LogY"), false).toBool());
+    renderer.setLimits(limits[0], limits[1], limits[2], limits[3]);
+    if (spec.contains(QStringLiteral("SecondaryLimits"))) {
+        if (!parseNumbers(spec.value(QStringLiteral("SecondaryLimits")), 4, limits)) {
+            *error = QStringLiteral("%1: invalid SecondaryLimits").arg(specFile);
+            return false;
+        }
+        renderer.setSecondaryLimits(limits[0], limits[1], limits[2], limits[3]);
+    }
+
+    renderer.setBackgroundColor(QColor(spec.value(QStringLiteral("Background"), QStringLiteral("black")).toString()));
+    renderer.setForegroundColor(QColor(spec.value(QStringLiteral("Foreground"), QStringLiteral("white")).toString()));
+    renderer.setGridColor(QColor(spec.value(QStringLiteral("GridColor"), QStringLiteral("gray")).toString()));
+    renderer.setShowGrid(spec.value(QStringLiteral("Grid"), false).toBool());
+    renderer.setAntialiasing(spec.value(QStringLiteral("Antialiasing"), false).toBool());
+
+    const struct {
+        KPlotRenderer::Axis type;
+        const char *key;
+    } axes[] = {
+        {KPlotRenderer::LeftAxis, "LeftLabel"},
+        {KPlotRenderer::BottomAxis, "BottomLabel"},
+        {KPlotRenderer::RightAxis, "RightLabel"},
+        {KPlotRenderer::TopAxis, "TopLabel"},
+    };
+    for (const auto &axis : axes) {
+        renderer.axis(axis.type)->setLabel(spec.value(QLatin1String(axis.key)).toString());
+    }
+
+    QString output = spec.value(QStringLiteral("Output"), info.completeBaseName() + QStringLiteral(".png")).toString();
+    spec.endGroup();
+    output = outputDir.isEmpty() ? dir.absoluteFilePath(output) : QDir(outputDir).absoluteFilePath(QFileInfo(output).fileName());
+
+    for (const auto &object : objects) {
+        renderer.addPlotObject(object.get());
+    }
+    if (!renderer.toImage(scale).save(output, "PNG")) {
+        *error = QStringLiteral("%1: cannot write %2").arg(specFile, output);
+        return false;
+    }
+    return true;
+}
+
+// Returns the peak resident set size of the process in bytes, or -1 if unknown
+qint64 peakMemory()
+{
+#ifdef Q_OS_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef Q_OS_MACOS
+        return usage.ru_maxrss;
+#else
+        return qint64(usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return -1;
+}
+}
+
+int main(int argc, char **argv)
+{
+    // Rendering needs no windowing system
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("kplotexport"));
+    QCoreApplication::setApplicationVersion(QStringLiteral(KPLOTTING_VERSION_STRING));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Renders KPlotting plot specs to PNG images in parallel."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption jobsOption({QStringLiteral("j"), QStringLiteral("jobs")},
+                                        QStringLiteral("Number of plots rendered at the same time (default: number of cores)."),
+                                        QStringLiteral("count"));
+    parser.addOption(jobsOption);
+    const QCommandLineOption outputOption({QStringLiteral("o"), QStringLiteral("output-dir")},
+                                          QStringLiteral("Write all images to this directory instead of next to their specs."),
+                                          QStringLiteral("dir"));
+    parser.addOption(outputOption);
+    const QCommandLineOption scaleOption(QStringLiteral("scale"), QStringLiteral("Device pixel ratio of the images (default: 1)."), QStringLiteral("ratio"));
+    parser.addOption(scaleOption);
+    parser.addPositionalArgument(QStringLiteral("specs"), QStringLiteral("Plot spec files."), QStringLiteral("spec..."));
+    parser.process(app);
+
+    const QStringList specs = parser.positionalArguments();
+    if (specs.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    QThreadPool pool;
+    if (parser.isSet(jobsOption)) {
+        bool ok;
+        const int jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobs < 1) {
+            qCritical("Invalid number of jobs: %s", qPrintable(parser.value(jobsOption)));
+            return 1;
+        }
+        pool.setMaxThreadCount(jobs);
+    }
+    qreal scale = 1.0;
+    if (parser.isSet(scaleOption)) {
+        bool ok;
+        scale = parser.value(scaleOption).toDouble(&ok);
+        if (!ok || scale <= 0.0) {
+            qCritical("Invalid scale: %s", qPrintable(parser.value(scaleOption)));
+            return 1;
+        }
+    }
+    const QString outputDir = parser.value(outputOption);
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+        qCritical("Cannot create %s", qPrintable(outputDir));
+        return 1;
+    }
+
+    std::atomic<int> rendered{0};
+    std::atomic<int> failed{0};
+    QElapsedTimer timer;
+    timer.start();
+    for (const QString &specFile : specs) {
+        pool.start([&, specFile] {
+            QString error;
+            if (renderSpec(specFile, outputDir, scale, &error)) {
+                ++rendered;
+            } else {
+                ++failed;
+                qWarning("%s", qPrintable(error));
+            }
+        });
+    }
+    pool.waitForDone();
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    QTextStream out(stdout);
+    out << "Rendered " << rendered.load() << " of " << specs.size() << " plots in " << QString::number(seconds, 'f', 2) << " s ("
+        << QString::number(rendered.load() / qMax(seconds, 1e-9), 'f', 1) << " plots/s) on " << pool.maxThreadCount() << " threads\n";
+    const qint64 peak = peakMemory();
+    if (peak >= 0) {
+        out << "Peak memory: " << QString::number(peak / (1024.0 * 1024.0), 'f', 1) << " MiB\n";
+    }
+
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,275 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "kplotkernels_p.h"
+
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QVarLengthArray>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Values per block that is reduced without tracking indices; only the
+// blocks holding the extremes are searched for their index afterwards
+#define MINMAXBLOCK 1024
+// Values per thread, below which a reduction is not split
+#define PARALLELVALUES (1 << 18)
+
+using KPlotKernels::MinMax;
+
+namespace
+{
+#ifdef __SSE2__
+// All bits set in the lanes of x that are finite: x - x is 0 for those,
+// and NaN for infinities and NaN
+inline __m128d finiteMask(__m128d x)
+{
+    return _mm_cmpeq_pd(_mm_sub_pd(x, x), _mm_setzero_pd());
+}
+
+// The lanes of x where mask is set, and fill in the others
+inline __m128d select(__m128d mask, __m128d x, __m128d fill)
+{
+    return _mm_or_pd(_mm_and_pd(mask, x), _mm_andnot_pd(mask, fill));
+}
+
+inline __m128d load(const double *v, qsizetype i, qsizetype stride)
+{
+    return stride == 1 ? _mm_loadu_pd(v + i) : _mm_set_pd(v[(i + 1) * stride], v[i * stride]);
+}
+
+inline double lowest(__m128d x)
+{
+    return qMin(_mm_cvtsd_f64(x), _mm_cvtsd_f64(_mm_unpackhi_pd(x, x)));
+}
+
+inline double highest(__m128d x)
+{
+    return qMax(_mm_cvtsd_f64(x), _mm_cvtsd_f64(_mm_unpackhi_pd(x, x)));
+}
+#endif
+
+// The extremes of the finite values of [begin, end), without their indices
+void scan(const double *v, qsizetype stride, qsizetype begin, qsizetype end, double *min, double *max)
+{
+    double lo = qInf();
+    double hi = -qInf();
+    qsizetype i = begin;
+#ifdef __SSE2__
+    // Two accumulators each, so that consecutive iterations do not wait
+    // for each other
+    const __m128d inf = _mm_set1_pd(qInf());
+    const __m128d ninf = _mm_set1_pd(-qInf());
+    __m128d lo0 = inf;
+    __m128d lo1 = inf;
+    __m128d hi0 = ninf;
+    __m128d hi1 = ninf;
+    for (; i + 4 <= end; i += 4) {
+        const __m128d a = load(v, i, stride);
+        const __m128d b = load(v, i + 2, stride);
+        const __m128d fa = finiteMask(a);
+        const __m128d fb = finiteMask(b);
+        lo0 = _mm_min_pd(lo0, select(fa, a, inf));
+        lo1 = _mm_min_pd(lo1, select(fb, b, inf));
+        hi0 = _mm_max_pd(hi0, select(fa, a, ninf));
+        hi1 = _mm_max_pd(hi1, select(fb, b, ninf));
+    }
+    lo = lowest(_mm_min_pd(lo0, lo1));
+    hi = highest(_mm_max_pd(hi0, hi1));
+#endif
+    for (; i < end; ++i) {
+        const double x = v[i * stride];
+        if (qIsFinite(x)) {
+            lo = qMin(lo, x);
+            hi = qMax(hi, x);
+        }
+    }
+    *min = lo;
+    *max = hi;
+}
+
+// The same for the points of [begin, end) with both coordinates finite
+void scan2(const double *xs, const double *ys, qsizetype begin, qsizetype end, double *minX, double *maxX, double *minY, double *maxY)
+{
+    double loX = qInf();
+    double hiX = -qInf();
+    double loY = qInf();
+    double hiY = -qInf();
+    qsizetype i = begin;
+#ifdef __SSE2__
+    const __m128d inf = _mm_set1_pd(qInf());
+    const __m128d ninf = _mm_set1_pd(-qInf());
+    __m128d vloX = inf;
+    __m128d vhiX = ninf;
+    __m128d vloY = inf;
+    __m128d vhiY = ninf;
+    for (; i + 2 <= end; i += 2) {
+        const __m128d x = _mm_loadu_pd(xs + i);
+        const __m128d y = _mm_loadu_pd(ys + i);
+        const __m128d f = _mm_and_pd(finiteMask(x), finiteMask(y));
+        vloX = _mm_min_pd(vloX, select(f, x, inf));
+        vhiX = _mm_max_pd(vhiX, select(f, x, ninf));
+        vloY = _mm_min_pd(vloY, select(f, y, inf));
+        vhiY = _mm_max_pd(vhiY, select(f, y, ninf));
+    }
+    loX = lowest(vloX);
+    hiX = highest(vhiX);
+    loY = lowest(vloY);
+    hiY = highest(vhiY);
+#endif
+    for (; i < end; ++i) {
+        if (qIsFinite(xs[i]) && qIsFinite(ys[i])) {
+            loX = qMin(loX, xs[i]);
+            hiX = qMax(hiX, xs[i]);
+            loY = qMin(loY, ys[i]);
+            hiY = qMax(hiY, ys[i]);
+        }
+    }
+    *minX = loX;
+    *maxX = hiX;
+    *minY = loY;
+    *maxY = hiY;
+}
+
+// Returns the first index in [begin, end) holding value, where the other
+// coordinate is finite if there is one
+qsizetype indexOf(const double *v, qsizetype stride, const double *other, qsizetype begin, qsizetype end, double value)
+{
+    for (qsizetype i = begin; i < end; ++i) {
+        if (v[i * stride] == value && (!other || qIsFinite(other[i]))) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Add the block of extremes min and max starting at index block to r,
+// remembering the block in place of the index until it is searched
+void addBlock(MinMax *r, double min, double max, qsizetype block)
+{
+    // Earlier blocks win ties, for the first occurrence
+    if (min < r->min) {
+        r->min = min;
+        r->argMin = block;
+    }
+    if (max > r->max) {
+        r->max = max;
+        r->argMax = block;
+    }
+}
+
+// Search the blocks remembered by addBlock() for the indices of the
+// extremes in v, which ends at end
+void resolve(MinMax *r, const double *v, qsizetype stride, const double *other, qsizetype end)
+{
+    if (r->argMin >= 0) {
+        r->argMin = indexOf(v, stride, other, r->argMin, qMin(r->argMin + MINMAXBLOCK, end), r->min);
+    }
+    if (r->argMax >= 0) {
+        r->argMax = indexOf(v, stride, other, r->argMax, qMin(r->argMax + MINMAXBLOCK, end), r->max);
+    }
+}
+
+// Add the extremes o of a later part of the values to r
+void merge(MinMax *r, const MinMax &o)
+{
+    if (o.argMin >= 0 && o.min < r->min) {
+        r->min = o.min;
+        r->argMin = o.argMin;
+    }
+    if (o.argMax >= 0 && o.max > r->max) {
+        r->max = o.max;
+        r->argMax = o.argMax;
+    }
+}
+
+int chunkCount(qsizetype n)
+{
+    if (n < 2 * PARALLELVALUES) {
+        return 1;
+    }
+    return int(qBound<qsizetype>(1, n / PARALLELVALUES, QThreadPool::globalInstance()->maxThreadCount()));
+}
+
+// Call f(k, begin, end) for each of the chunks k of [0, n), in parallel
+template<typename F>
+void forEachChunk(int chunks, qsizetype n, F f)
+{
+    if (chunks == 1) {
+        f(0, 0, n);
+        return;
+    }
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore done;
+    for (int k = 0; k < chunks - 1; ++k) {
+        auto job = [&, k] {
+            f(k, n * k / chunks, n * (k + 1) / chunks);
+            done.release();
+        };
+        // Without a free thread the chunk is reduced here, so that a
+        // reduction running on the pool never waits for the pool
+        if (!pool->tryStart(job)) {
+            job();
+        }
+    }
+    f(chunks - 1, n * (chunks - 1) / chunks, n);
+    done.acquire(chunks - 1);
+}
+}
+
+MinMax KPlotKernels::minMax(const double *values, qsizetype n, qsizetype stride)
+{
+    const int chunks = chunkCount(n);
+    QVarLengthArray<MinMax, 16> parts(chunks);
+    forEachChunk(chunks, n, [&](int k, qsizetype begin, qsizetype end) {
+        MinMax &r = parts[k];
+        for (qsizetype b = begin; b < end; b += MINMAXBLOCK) {
+            double min;
+            double max;
+            scan(values, stride, b, qMin(b + MINMAXBLOCK, end), &min, &max);
+            addBlock(&r, min, max, b);
+        }
+        resolve(&r, values, stride, nullptr, end);
+    });
+
+    MinMax r;
+    for (int k = 0; k < chunks; ++k) {
+        merge(&r, parts[k]);
+    }
+    return r;
+}
+
+void KPlotKernels::minMax2(const double *xs, const double *ys, qsizetype n, MinMax *x, MinMax *y)
+{
+    const int chunks = chunkCount(n);
+    QVarLengthArray<MinMax, 16> partsX(chunks);
+    QVarLengthArray<MinMax, 16> partsY(chunks);
+    forEachChunk(chunks, n, [&](int k, qsizetype begin, qsizetype end) {
+        MinMax &rx = partsX[k];
+        MinMax &ry = partsY[k];
+        for (qsizetype b = begin; b < end; b += MINMAXBLOCK) {
+            double minX;
+            double maxX;
+            double minY;
+            double maxY;
+            scan2(xs, ys, b, qMin(b + MINMAXBLOCK, end), &minX, &maxX, &minY, &maxY);
+            addBlock(&rx, minX, maxX, b);
+            addBlock(&ry, minY, maxY, b);
+        }
+        resolve(&rx, xs, 1, ys, end);
+        resolve(&ry, ys, 1, xs, end);
+    });
+
+    *x = MinMax();
+    *y = MinMax();
+    for (int k = 0; k < chunks; ++k) {
+        merge(x, partsX[k]);
+        merge(y, partsY[k]);
+    }
+}
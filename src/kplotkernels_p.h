@@ -0,0 +1,52 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KPLOTKERNELS_P_H
+#define KPLOTKERNELS_P_H
+
+#include <QtGlobal>
+#include <QtNumeric>
+
+/*
+ * Reductions over long arrays of coordinates, shared by the extents and
+ * the decimation of plot objects.
+ *
+ * Values that are not finite cannot be plotted and are skipped.  The
+ * reductions use SIMD instructions where available, and split ranges of
+ * more than a few hundred thousand values across the global thread pool.
+ */
+namespace KPlotKernels
+{
+// The smallest and the largest of a range of values, with the index of
+// their first occurrence; the indices are -1 if there was no value
+struct MinMax {
+    double min = qInf();
+    double max = -qInf();
+    qsizetype argMin = -1;
+    qsizetype argMax = -1;
+
+    bool isEmpty() const
+    {
+        return argMin < 0;
+    }
+};
+
+/*
+ * Returns the extremes of the n values values[0], values[stride],
+ * values[2 * stride], ...  The indices count values, not doubles.
+ */
+MinMax minMax(const double *values, qsizetype n, qsizetype stride = 1);
+
+/*
+ * Returns in x and y the extremes of the coordinates of the n points
+ * (xs[i], ys[i]), skipping the points that have a coordinate that is not
+ * finite.
+ */
+void minMax2(const double *xs, const double *ys, qsizetype n, MinMax *x, MinMax *y);
+}
+
+#endif
@@ -0,0 +1,288 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2003 Jason Harris <kstars@30doradus.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "kplotmask_p.h"
+
+#include <QPainter>
+
+#include <math.h>
+
+#include "kplottransform_p.h"
+
+void KPlotMask::reset(const QSize &size)
+{
+    m_rect = QRect(QPoint(0, 0), size);
+    m_mask = QImage(size, QImage::Format_ARGB32);
+    QColor fillColor = Qt::black;
+    fillColor.setAlpha(128);
+    m_mask.fill(fillColor.rgb());
+}
+
+void KPlotMask::maskRect(const QRectF &rf, float fvalue)
+{
+    QRect r = rf.toRect().intersected(m_rect);
+    int value = int(fvalue);
+    QColor newColor;
+    for (int ix = r.left(); ix < r.right(); ++ix) {
+        for (int iy = r.top(); iy < r.bottom(); ++iy) {
+            newColor = QColor(m_mask.pixel(ix, iy));
+            newColor.setAlpha(200);
+            newColor.setRed(qMin(newColor.red() + value, 255));
+            m_mask.setPixel(ix, iy, newColor.rgba());
+        }
+    }
+}
+
+void KPlotMask::maskAlongLine(const QPointF &p1, const QPointF &p2, float fvalue)
+{
+    // Only the part of the line inside the plot can be masked; clipping it
+    // first keeps the loops below within the pixels of the plot.
+    QPointF a = p1;
+    QPointF b = p2;
+    if (!kplotClipLine(&a, &b, QRectF(m_rect))) {
+        return;
+    }
+
+    int value = int(fvalue);
+
+    const double dx = b.x() - a.x();
+    const double dy = b.y() - a.y();
+    QColor newColor;
+
+    // Mask each pixel along the line joining a and b
+    if (qAbs(dy) > qAbs(dx)) { // step in y-direction
+        int y1 = int(a.y());
+        int y2 = int(b.y());
+        if (y1 > y2) {
+            y1 = int(b.y());
+            y2 = int(a.y());
+        }
+
+        for (int y = y1; y <= y2; ++y) {
+            int x = int(a.x() + (y - a.y()) * dx / dy);
+            if (m_rect.contains(x, y)) {
+                newColor = QColor(m_mask.pixel(x, y));
+                newColor.setAlpha(100);
+                newColor.setRed(qMin(newColor.red() + value, 255));
+                m_mask.setPixel(x, y, newColor.rgba());
+            }
+        }
+
+    } else { // step in x-direction
+        int x1 = int(a.x());
+        int x2 = int(b.x());
+        if (x1 > x2) {
+            x1 = int(b.x());
+            x2 = int(a.x());
+        }
+
+        const double m = dx != 0.0 ? dy / dx : 0.0;
+        for (int x = x1; x <= x2; ++x) {
+            int y = int(a.y() + (x - a.x()) * m);
+            if (m_rect.contains(x, y)) {
+                newColor = QColor(m_mask.pixel(x, y));
+                newColor.setAlpha(100);
+                newColor.setRed(qMin(newColor.red() + value, 255));
+                m_mask.setPixel(x, y, newColor.rgba());
+            }
+        }
+    }
+}
+
+// Determine optimal placement for a text label for position pos.  We want
+// the label to be near position pos, but we don't want it to overlap with
+// other labels or plot elements.  We will use a "downhill simplex"
+// algorithm to find a label position that minimizes the pixel values
+// in the plotMask image over the label's rect().  The sum of pixel
+// values in the label's rect is the "cost" of placing the label there.
+//
+// Because a downhill simplex follows the local gradient to find low
+// values, it can get stuck in local minima.  To mitigate this, we will
+// iteratively attempt each of the initial path offset directions (up,
+// down, right, left) in the order of increasing cost at each location.
+void KPlotMask::placeLabel(QPainter *painter, const QPointF &pos, const QString &label)
+{
+    int textFlags = Qt::TextSingleLine | Qt::AlignCenter;
+
+    if (!m_rect.contains(pos.toPoint())) {
+        return;
+    }
+
+    QFontMetricsF fm(painter->font(), painter->device());
+    QRectF bestRect = fm.boundingRect(QRectF(pos.x(), pos.y(), 1, 1), textFlags, label);
+    float xStep = 0.5 * bestRect.width();
+    float yStep = 0.5 * bestRect.height();
+    float maxCost = 0.05 * bestRect.width() * bestRect.height();
+    float bestCost = rectCost(bestRect);
+
+    // We will travel along a path defined by the maximum decrease in
+    // the cost at each step.  If this path takes us to a local minimum
+    // whose cost exceeds maxCost, then we will restart at the
+    // beginning and select the next-best path.  The indices of
+    // already-tried paths are stored in the TriedPathIndex list.
+    //
+    // If we try all four first-step paths and still don't get below
+    // maxCost, then we'll adopt the local minimum position with the
+    // best cost (designated as bestBadCost).
+    int iter = 0;
+    QList<int> TriedPathIndex;
+    float bestBadCost = 10000;
+    QRectF bestBadRect;
+
+    // needed to halt iteration from inside the switch
+    bool flagStop = false;
+
+    while (bestCost > maxCost) {
+        // Displace the label up, down, left, right; determine which
+        // step provides the lowest cost
+        QRectF upRect = bestRect;
+        upRect.moveTop(upRect.top() + yStep);
+        float upCost = rectCost(upRect);
+        QRectF downRect = bestRect;
+        downRect.moveTop(downRect.top() - yStep);
+        float downCost = rectCost(downRect);
+        QRectF leftRect = bestRect;
+        leftRect.moveLeft(leftRect.left() - xStep);
+        float leftCost = rectCost(leftRect);
+        QRectF rightRect = bestRect;
+        rightRect.moveLeft(rightRect.left() + xStep);
+        float rightCost = rectCost(rightRect);
+
+        // which direction leads to the lowest cost?
+        QList<float> costList;
+        costList << upCost << downCost << leftCost << rightCost;
+        int imin = -1;
+        for (int i = 0; i < costList.size(); ++i) {
+            if (iter == 0 && TriedPathIndex.contains(i)) {
+                continue; // Skip this first-step path, we already tried it!
+            }
+
+            // If this first-step path doesn't improve the cost,
+            // skip this direction from now on
+            if (iter == 0 && costList[i] >= bestCost) {
+                TriedPathIndex.append(i);
+                continue;
+            }
+
+            if (costList[i] < bestCost && (imin < 0 || costList[i] < costList[imin])) {
+                imin = i;
+            }
+        }
+
+        // Make a note that we've tried the current first-step path
+        if (iter == 0 && imin >= 0) {
+            TriedPathIndex.append(imin);
+        }
+
+        // Adopt the step that produced the best cost
+        switch (imin) {
+        case 0: // up
+            bestRect.moveTop(upRect.top());
+            bestCost = upCost;
+            break;
+        case 1: // down
+            bestRect.moveTop(downRect.top());
+            bestCost = downCost;
+            break;
+        case 2: // left
+            bestRect.moveLeft(leftRect.left());
+            bestCost = leftCost;
+            break;
+        case 3: // right
+            bestRect.moveLeft(rightRect.left());
+            bestCost = rightCost;
+            break;
+        case -1: // no lower cost found!
+            // We hit a local minimum.  Keep the best of these as bestBadRect
+            if (bestCost < bestBadCost) {
+                bestBadCost = bestCost;
+                bestBadRect = bestRect;
+            }
+
+            // If all of the first-step paths have now been searched, we'll
+            // have to adopt the bestBadRect
+            if (TriedPathIndex.size() == 4) {
+                bestRect = bestBadRect;
+                flagStop = true; // halt iteration
+                break;
+            }
+
+            // If we haven't yet tried all of the first-step paths, start over
+            if (TriedPathIndex.size() < 4) {
+                iter = -1; // anticipating the ++iter below
+                bestRect = fm.boundingRect(QRectF(pos.x(), pos.y(), 1, 1), textFlags, label);
+                bestCost = rectCost(bestRect);
+            }
+            break;
+        }
+
+        // Halt iteration, because we've tried all directions and
+        // haven't gotten below maxCost (we'll adopt the best
+        // local minimum found)
+        if (flagStop) {
+            break;
+        }
+
+        ++iter;
+    }
+
+    painter->drawText(bestRect, textFlags, label);
+
+    // Is a line needed to connect the label to the point?
+    float deltax = pos.x() - bestRect.center().x();
+    float deltay = pos.y() - bestRect.center().y();
+    float rbest = sqrt(deltax * deltax + deltay * deltay);
+    if (rbest > 20.0) {
+        // Draw a rectangle around the label
+        painter->setBrush(QBrush());
+        // QPen pen = painter->pen();
+        // pen.setStyle( Qt::DotLine );
+        // painter->setPen( pen );
+        painter->drawRoundedRect(bestRect, 25, 25, Qt::RelativeSize);
+
+        // Now connect the label to the point with a line.
+        // The line is drawn from the center of the near edge of the rectangle
+        float xline = bestRect.center().x();
+        if (bestRect.left() > pos.x()) {
+            xline = bestRect.left();
+        }
+        if (bestRect.right() < pos.x()) {
+            xline = bestRect.right();
+        }
+
+        float yline = bestRect.center().y();
+        if (bestRect.top() > pos.y()) {
+            yline = bestRect.top();
+        }
+        if (bestRect.bottom() < pos.y()) {
+            yline = bestRect.bottom();
+        }
+
+        painter->drawLine(QPointF(xline, yline), pos);
+    }
+
+    // Mask the label's rectangle so other labels won't overlap it.
+    maskRect(bestRect);
+}
+
+float KPlotMask::rectCost(const QRectF &r) const
+{
+    if (!m_mask.rect().contains(r.toRect())) {
+        return 10000.;
+    }
+
+    // Compute sum of mask values in the rect r
+    QImage subMask = m_mask.copy(r.toRect());
+    int cost = 0;
+    for (int ix = 0; ix < subMask.width(); ++ix) {
+        for (int iy = 0; iy < subMask.height(); ++iy) {
+            cost += QColor(subMask.pixel(ix, iy)).red();
+        }
+    }
+
+    return float(cost);
+}
@@ -0,0 +1,49 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2003 Jason Harris <kstars@30doradus.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KPLOTMASK_P_H
+#define KPLOTMASK_P_H
+
+#include <QImage>
+#include <QRect>
+
+class QPainter;
+
+/*
+ * The regions of a plot that object labels should avoid, with the
+ * placement of the labels.  Coordinates are pixels of the plot area.
+ *
+ * A mask is only used by one painting at a time, so that objects can be
+ * drawn with their own mask on other threads.
+ */
+class KPlotMask
+{
+public:
+    // Clear the mask for a plot area of the given size
+    void reset(const QSize &size);
+
+    void maskRect(const QRectF &r, float value = 1.0f);
+    void maskAlongLine(const QPointF &p1, const QPointF &p2, float value = 1.0f);
+    // Draw label close to pos, avoiding the masked regions
+    void placeLabel(QPainter *painter, const QPointF &pos, const QString &label);
+
+private:
+    /*
+     * Returns a value indicating how well the given rectangle is
+     * avoiding masked regions in the plot.  A higher returned value
+     * indicates that the rectangle is intersecting a larger portion
+     * of the masked region, or a portion of the masked region which
+     * is weighted higher.
+     */
+    float rectCost(const QRectF &r) const;
+
+    // Array holding the mask of "used" regions of the plot
+    QImage m_mask;
+    QRect m_rect;
+};
+
+#endif
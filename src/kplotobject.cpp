@@ -6,36 +6,606 @@
 */
 
 #include "kplotobject.h"
+#include "kplotkernels_p.h"
+#include "kplotmask_p.h"
+#include "kplotobject_p.h"
 
+#include <QBitArray>
 #include <QDebug>
 #include <QPainter>
 #include <QtAlgorithms>
 
+#include <algorithm>
+#include <atomic>
+
 #include "kplotpoint.h"
+#include "kplotpoint_p.h"
+#include "kplotrenderer.h"
+#include "kplotrenderer_p.h"
 #include "kplotwidget.h"
 
-class KPlotObject::Private
+// The size of the cells of the grid for hit tests, in pixels
+#define POINTGRIDCELL 16
+
+// Revisions are unique across all objects, so that a cache entry of a
+// deleted object is never taken for one of a new object at the same address.
+static quint64 nextRevision()
+{
+    static std::atomic<quint64> counter{0};
+    return ++counter;
+}
+
+void KPlotObject::Private::changed()
+{
+    revision = nextRevision();
+    resetRevision = revision;
+    notifyWidgets(-1);
+}
+
+void KPlotObject::Private::styleChanged()
+{
+    revision = nextRevision();
+    resetRevision = revision;
+    notifyWidgets(0);
+}
+
+void KPlotObject::Private::pointsAppended(qsizetype first)
+{
+    revision = nextRevision();
+    notifyWidgets(first);
+}
+
+void KPlotObject::Private::notifyWidgets(qsizetype first)
+{
+    if (updateDepth > 0) {
+        // Keep the widest of the changes, any change of all points beating the rest
+        if (!notifyPending) {
+            pendingFirst = first;
+        } else if (first < 0 || pendingFirst < 0) {
+            pendingFirst = -1;
+        } else {
+            pendingFirst = qMin(pendingFirst, first);
+        }
+        notifyPending = true;
+        return;
+    }
+    for (KPlotWidget *w : std::as_const(widgets)) {
+        w->plotObjectChanged(q, first);
+    }
+}
+
+std::unique_ptr<KPlotObject::Private> KPlotObject::Private::snapshot() const
+{
+    std::unique_ptr<Private> s(new Private(nullptr));
+    // The columns are implicitly shared, so this does not copy the data
+    s->xColumn = xColumn;
+    s->yColumn = yColumn;
+    s->uniformX = uniformX;
+    s->x0 = x0;
+    s->dx = dx;
+    s->logXColumn = logXColumn;
+    s->logYColumn = logYColumn;
+    s->pointValues = pointValues;
+    s->pointSizes = pointSizes;
+    s->labelColumn = labelColumn;
+    s->barWidthColumn = barWidthColumn;
+    s->maxBarWidth = maxBarWidth;
+    s->revision = revision;
+    s->resetRevision = resetRevision;
+    s->labelCount = labelCount;
+    copyStyle(s.get());
+    return s;
+}
+
+std::unique_ptr<KPlotObject::Private> KPlotObject::Private::decimated(const KPlotTransform &t) const
+{
+    qsizetype first;
+    qsizetype last;
+    visibleRange(t.dataRect().left(), t.dataRect().right(), &first, &last);
+    const qsizetype maxPoints = 4 * (qMax(t.pixRect().width(), 0) + 1);
+    if ((type & Bars) || labelCount > 0 || last - first <= maxPoints) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Private> s(new Private(nullptr));
+    s->xColumn.reserve(maxPoints);
+    s->yColumn.reserve(maxPoints);
+    auto keep = [&](qsizetype i) {
+        s->xColumn.append(xAt(i));
+        s->yColumn.append(yColumn[i]);
+        if (i < pointValues.size()) {
+            s->pointValues.append(pointValues[i]);
+        }
+        if (i < pointSizes.size()) {
+            s->pointSizes.append(pointSizes[i]);
+        }
+    };
+
+    if (sortedX) {
+        // Lines through the first, last and extreme points of each pixel
+        // column cover the same pixels as lines through all of its points.
+        // The points of a column are found by binary search, as mapping is
+        // monotonic, and its extremes by a reduction.
+        const double *ys = yColumn.constData();
+        for (qsizetype iFirst = first; iFirst < last;) {
+            // Points that cannot be mapped end up in columns of their own
+            const double column = floor(t.mapX(xAt(iFirst)));
+            auto inColumn = [&](qsizetype i) {
+                return floor(t.mapX(xAt(i))) == column;
+            };
+            // The column ends in [lo, hi]
+            qsizetype lo = iFirst + 1;
+            qsizetype hi = last;
+            if (uniformX && dx > 0.0) {
+                // Uniform samples give the end of the column directly,
+                // up to rounding
+                const double end = ceil((t.unmapX(column + 1.0) - x0) / dx);
+                if (end > lo && end < hi) {
+                    const qsizetype guess = qsizetype(end);
+                    if (!inColumn(guess - 1)) {
+                        hi = guess - 1;
+                    } else {
+                        lo = guess;
+                        if (!inColumn(guess)) {
+                            hi = guess;
+                        }
+                    }
+                }
+            }
+            while (lo < hi) {
+                const qsizetype mid = lo + (hi - lo) / 2;
+                if (inColumn(mid)) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            const qsizetype end = lo;
+            const KPlotKernels::MinMax extremes = KPlotKernels::minMax(ys + iFirst, end - iFirst);
+            qsizetype kept[4] = {iFirst, iFirst, iFirst, end - 1};
+            if (!extremes.isEmpty()) {
+                kept[1] = iFirst + extremes.argMin;
+                kept[2] = iFirst + extremes.argMax;
+            }
+            std::sort(kept, kept + 4);
+            for (int k = 0; k < 4; ++k) {
+                if (k == 0 || kept[k] != kept[k - 1]) {
+                    keep(kept[k]);
+                }
+            }
+            iFirst = end;
+        }
+    } else {
+        const qsizetype stride = (last - first + maxPoints - 1) / maxPoints;
+        for (qsizetype i = first; i < last; i += stride) {
+            keep(i);
+        }
+    }
+
+    copyStyle(s.get());
+    return s;
+}
+
+void KPlotObject::Private::copyStyle(Private *s) const
+{
+    s->sortedX = sortedX;
+    s->type = type;
+    s->pointStyle = pointStyle;
+    s->size = size;
+    s->maxPointSize = maxPointSize;
+    s->pointDensityLimit = pointDensityLimit;
+    s->colorTable = colorTable;
+    s->minimumValue = minimumValue;
+    s->maximumValue = maximumValue;
+    s->pen = pen;
+    s->linePen = linePen;
+    s->barPen = barPen;
+    s->labelPen = labelPen;
+    s->brush = brush;
+    s->barBrush = barBrush;
+}
+
+void KPlotObject::Private::updatePointGrid(const KPlotTransform &t, int radius)
+{
+    const QRect area = t.pixRect().adjusted(-radius, -radius, radius, radius);
+    if (pointGrid.valid && pointGrid.revision == revision && pointGrid.transform == t && pointGrid.area == area) {
+        return;
+    }
+
+    PointGrid &g = pointGrid;
+    g = PointGrid();
+    g.transform = t;
+    g.revision = revision;
+    g.area = area;
+    g.columns = qMax(area.width(), 0) / POINTGRIDCELL + 1;
+    g.rows = qMax(area.height(), 0) / POINTGRIDCELL + 1;
+
+    // Only points in the visible x-range, plus the radius, can be hit
+    const double x1 = t.unmapX(-radius);
+    const double x2 = t.unmapX(t.pixRect().width() + radius);
+    qsizetype first;
+    qsizetype last;
+    visibleRange(qMin(x1, x2), qMax(x1, x2), &first, &last);
+
+    // Bucket the points by cell, in two passes to size the cells first
+    QList<int> cells;
+    QList<QPoint> positions;
+    cells.reserve(last - first);
+    positions.reserve(last - first);
+    g.starts.fill(0, qsizetype(g.columns) * g.rows + 1);
+    for (qsizetype i = first; i < last; ++i) {
+        const QPointF q = t.map(QPointF(xAt(i), yColumn[i]));
+        if (!qIsFinite(q.x()) || !qIsFinite(q.y()) || !QRectF(area).contains(q)) {
+            cells.append(-1);
+            positions.append(QPoint());
+            continue;
+        }
+        const QPoint pos = q.toPoint();
+        positions.append(pos);
+        const int column = qBound(0, (pos.x() - area.left()) / POINTGRIDCELL, g.columns - 1);
+        const int row = qBound(0, (pos.y() - area.top()) / POINTGRIDCELL, g.rows - 1);
+        cells.append(row * g.columns + column);
+        ++g.starts[cells.last() + 1];
+    }
+    for (qsizetype c = 1; c < g.starts.size(); ++c) {
+        g.starts[c] += g.starts[c - 1];
+    }
+    g.indices.resize(g.starts.last());
+    g.positions.resize(g.starts.last());
+    QList<qsizetype> next = g.starts;
+    for (qsizetype i = first; i < last; ++i) {
+        const int cell = cells[i - first];
+        if (cell >= 0) {
+            const qsizetype k = next[cell]++;
+            g.indices[k] = i;
+            g.positions[k] = positions[i - first];
+        }
+    }
+    g.valid = true;
+}
+
+QList<qsizetype> KPlotObject::Private::pointsNear(const KPlotTransform &t, const QPoint &p, int radius, qsizetype *nearest)
+{
+    syncColumns();
+    updatePointGrid(t, radius);
+    const PointGrid &g = pointGrid;
+
+    QList<qsizetype> result;
+    int nearestDistance = radius + 1;
+    if (nearest) {
+        *nearest = -1;
+    }
+
+    // The cells that the diamond of the radius around p touches
+    const QRect around = QRect(p.x() - radius, p.y() - radius, 2 * radius + 1, 2 * radius + 1) & g.area;
+    if (around.isEmpty()) {
+        return result;
+    }
+    const int column1 = (around.left() - g.area.left()) / POINTGRIDCELL;
+    const int column2 = qMin((around.right() - g.area.left()) / POINTGRIDCELL, g.columns - 1);
+    const int row1 = (around.top() - g.area.top()) / POINTGRIDCELL;
+    const int row2 = qMin((around.bottom() - g.area.top()) / POINTGRIDCELL, g.rows - 1);
+    for (int row = row1; row <= row2; ++row) {
+        for (int column = column1; column <= column2; ++column) {
+            const int cell = row * g.columns + column;
+            for (qsizetype k = g.starts[cell]; k < g.starts[cell + 1]; ++k) {
+                const int distance = (p - g.positions[k]).manhattanLength();
+                if (distance > radius) {
+                    continue;
+                }
+                result.append(g.indices[k]);
+                if (nearest && (distance < nearestDistance || (distance == nearestDistance && g.indices[k] < *nearest))) {
+                    nearestDistance = distance;
+                    *nearest = g.indices[k];
+                }
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+double KPlotObject::Private::reach() const
+{
+    return qMax(size, maxPointSize) + qMax(pen.widthF(), linePen.widthF()) + 2.0;
+}
+
+void KPlotObject::Private::appendColumns(const KPlotPoint *p)
+{
+    const double x = p->x();
+    if (!xColumn.isEmpty() && !(x >= xColumn.last())) {
+        sortedX = false;
+    }
+    const qsizetype i = xColumn.size();
+    if (p->barWidth() != 0.0) {
+        maxBarWidth = qMax(maxBarWidth, p->barWidth());
+        barWidthColumn.resize(i);
+        barWidthColumn.append(p->barWidth());
+    }
+    if (!p->label().isEmpty()) {
+        ++labelCount;
+        labelColumn.resize(i);
+        labelColumn.append(p->label());
+    }
+    const double y = p->y();
+    if (extentsValid && qIsFinite(x) && qIsFinite(y)) {
+        minX = qMin(minX, x);
+        maxX = qMax(maxX, x);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+    }
+    xColumn.append(x);
+    yColumn.append(y);
+}
+
+void KPlotObject::Private::pointEdited()
+{
+    // The drawings of the object are out of date from now on, but the
+    // columns are only rebuilt once, when they are read
+    revision = nextRevision();
+    resetRevision = revision;
+    columnsDirty = true;
+    // Edited samples are no longer uniform
+    makeExplicit();
+}
+
+void KPlotObject::Private::syncColumns()
+{
+    if (columnsDirty) {
+        rebuildColumns();
+    }
+}
+
+void KPlotObject::Private::setOwner(KPlotPoint *p, KPlotObject *owner)
+{
+    p->d->owner = owner;
+}
+
+void KPlotObject::Private::rebuildColumns()
+{
+    columnsDirty = false;
+    if (uniformX) {
+        // Only the y-coordinates are stored, there is nothing to rebuild from
+        logYColumn.clear();
+        extentsValid = false;
+        mappedValid = false;
+        return;
+    }
+    xColumn.clear();
+    yColumn.clear();
+    xColumn.reserve(pList.size());
+    yColumn.reserve(pList.size());
+    sortedX = true;
+    maxBarWidth = 0.0;
+    labelCount = 0;
+    labelColumn.clear();
+    barWidthColumn.clear();
+    // Recomputed in one pass when they are needed
+    extentsValid = false;
+    for (const KPlotPoint *p : std::as_const(pList)) {
+        appendColumns(p);
+    }
+    logXColumn.clear();
+    logYColumn.clear();
+    mappedValid = false;
+}
+
+void KPlotObject::Private::makeExplicit()
+{
+    if (!uniformX) {
+        return;
+    }
+    // The points keep their positions, so the extents and the mapped
+    // points stay valid
+    const qsizetype n = yColumn.size();
+    xColumn.resize(n);
+    pList.reserve(n);
+    for (qsizetype i = 0; i < n; ++i) {
+        KPlotPoint *p = samplePoints.value(i);
+        if (!p) {
+            p = new KPlotPoint(x0 + i * dx, yColumn[i]);
+            setOwner(p, q);
+        }
+        xColumn[i] = p->x();
+        pList.append(p);
+    }
+    samplePoints.clear();
+    logXColumn.clear();
+    uniformX = false;
+}
+
+KPlotPoint *KPlotObject::Private::pointAt(qsizetype i)
+{
+    if (!uniformX) {
+        return pList[i];
+    }
+    KPlotPoint *&p = samplePoints[i];
+    if (!p) {
+        p = new KPlotPoint(xAt(i), yColumn[i]);
+        setOwner(p, q);
+    }
+    return p;
+}
+
+bool KPlotObject::Private::isNextSample(double x) const
+{
+    // Allowing for the rounding of x0 as the samples are trimmed
+    return uniformX && qAbs(x - xAt(count())) <= 1e-6 * qAbs(dx);
+}
+
+void KPlotObject::Private::appendSample(double y)
+{
+    const double x = xAt(count());
+    if (extentsValid && qIsFinite(x) && qIsFinite(y)) {
+        minX = qMin(minX, x);
+        maxX = qMax(maxX, x);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+    }
+    yColumn.append(y);
+}
+
+void KPlotObject::Private::resetExtents()
+{
+    minX = minY = qInf();
+    maxX = maxY = -qInf();
+    extentsValid = true;
+}
+
+bool KPlotObject::Private::extents(double *x1, double *x2, double *y1, double *y2)
+{
+    syncColumns();
+    if (!extentsValid && uniformX) {
+        resetExtents();
+        const KPlotKernels::MinMax y = KPlotKernels::minMax(yColumn.constData(), yColumn.size());
+        if (!y.isEmpty() && qIsFinite(x0) && qIsFinite(dx)) {
+            // The first and last samples with a finite y bound x
+            qsizetype i1 = 0;
+            while (!qIsFinite(yColumn[i1])) {
+                ++i1;
+            }
+            qsizetype i2 = yColumn.size() - 1;
+            while (!qIsFinite(yColumn[i2])) {
+                --i2;
+            }
+            minX = qMin(xAt(i1), xAt(i2));
+            maxX = qMax(xAt(i1), xAt(i2));
+            minY = y.min;
+            maxY = y.max;
+        }
+    } else if (!extentsValid) {
+        KPlotKernels::MinMax x;
+        KPlotKernels::MinMax y;
+        KPlotKernels::minMax2(xColumn.constData(), yColumn.constData(), xColumn.size(), &x, &y);
+        minX = x.min;
+        maxX = x.max;
+        minY = y.min;
+        maxY = y.max;
+        extentsValid = true;
+    }
+    if (minX > maxX) {
+        return false;
+    }
+    *x1 = minX;
+    *x2 = maxX;
+    *y1 = minY;
+    *y2 = maxY;
+    return true;
+}
+
+static const QList<double> &scaledColumn(const QList<double> &column, QList<double> &logColumn, bool log)
 {
-public:
-    Private(KPlotObject *qq)
-        : q(qq)
-    {
+    if (!log) {
+        return column;
     }
 
-    ~Private()
-    {
-        qDeleteAll(pList);
+    // Only the values added since the last call need to be transformed
+    const qsizetype n = column.size();
+    qsizetype i = logColumn.size();
+    logColumn.resize(n);
+    const double *in = column.constData();
+    double *out = logColumn.data();
+    for (; i < n; ++i) {
+        out[i] = log10(in[i]);
+    }
+    return logColumn;
+}
+
+const QList<double> &KPlotObject::Private::scaledXColumn(bool log)
+{
+    return scaledColumn(xColumn, logXColumn, log);
+}
+
+const QList<double> &KPlotObject::Private::scaledYColumn(bool log)
+{
+    return scaledColumn(yColumn, logYColumn, log);
+}
+
+void KPlotObject::Private::visibleRange(double x1, double x2, qsizetype *first, qsizetype *last) const
+{
+    const qsizetype n = count();
+    if (!sortedX) {
+        *first = 0;
+        *last = n;
+        return;
+    }
+
+    // Keep one neighbour on each side, so that lines leaving the
+    // visible range are still drawn up to the edge.
+    qsizetype i1;
+    qsizetype i2;
+    if (uniformX) {
+        // Computed from the spacing of the samples, then corrected for
+        // rounding to match the searches below
+        auto index = [&](double x) {
+            return qsizetype(qBound(0.0, ceil((x - x0) / dx), double(n)));
+        };
+        i1 = index(x1);
+        while (i1 > 0 && !(xAt(i1 - 1) < x1)) {
+            --i1;
+        }
+        while (i1 < n && xAt(i1) < x1) {
+            ++i1;
+        }
+        i2 = qMax(index(x2), i1);
+        while (i2 > i1 && x2 < xAt(i2 - 1)) {
+            --i2;
+        }
+        while (i2 < n && !(x2 < xAt(i2))) {
+            ++i2;
+        }
+    } else {
+        const auto begin = xColumn.cbegin();
+        i1 = std::lower_bound(begin, xColumn.cend(), x1) - begin;
+        i2 = std::upper_bound(begin + i1, xColumn.cend(), x2) - begin;
+    }
+    *first = qMax(i1 - 1, qsizetype(0));
+    *last = qMin(i2 + 1, n);
+}
+
+void KPlotObject::Private::mapRange(const KPlotTransform &t, qsizetype first, qsizetype last)
+{
+    if (first >= last) {
+        return;
     }
+    const QList<double> &sy = scaledYColumn(t.isLogY());
+    if (uniformX) {
+        // The x-coordinates are computed into a small buffer at a time
+        const bool log = t.isLogX();
+        double sx[256];
+        for (qsizetype i = first; i < last; i += 256) {
+            const qsizetype n = qMin(last - i, qsizetype(256));
+            for (qsizetype k = 0; k < n; ++k) {
+                sx[k] = scaledXAt(i + k, log);
+            }
+            t.mapScaled(sx, sy.constData() + i, n, mappedPoints.data() + i);
+        }
+        return;
+    }
+    const QList<double> &sx = scaledXColumn(t.isLogX());
+    t.mapScaled(sx.constData() + first, sy.constData() + first, last - first, mappedPoints.data() + first);
+}
 
-    KPlotObject *q;
+void KPlotObject::Private::mapPoints(const KPlotTransform &t, qsizetype first, qsizetype last)
+{
+    mappedPoints.resize(count());
+
+    if (mappedValid && mappedTransform == t && first <= mappedLast && last >= mappedFirst) {
+        // Only map what is not yet known for this transform, e.g. the
+        // points appended since the last call.
+        mapRange(t, first, mappedFirst);
+        mapRange(t, mappedLast, last);
+        mappedFirst = qMin(first, mappedFirst);
+        mappedLast = qMax(last, mappedLast);
+        return;
+    }
 
-    QList<KPlotPoint *> pList;
-    PlotTypes type;
-    PointStyle pointStyle;
-    double size;
-    QPen pen, linePen, barPen, labelPen;
-    QBrush brush, barBrush;
-};
+    mapRange(t, first, last);
+    mappedFirst = first;
+    mappedLast = last;
+    mappedTransform = t;
+    mappedValid = true;
+}
 
 KPlotObject::KPlotObject(const QColor &c, PlotType t, double size, PointStyle ps)
     : d(new Private(this))
@@ -53,7 +623,13 @@ KPlotObject::KPlotObject(const QColor &c, PlotType t, double size, PointStyle ps
     setPointStyle(ps);
 }
 
-KPlotObject::~KPlotObject() = default;
+KPlotObject::~KPlotObject()
+{
+    // Widgets that do not own the object would be left pointing to it
+    for (KPlotWidget *w : std::as_const(d->widgets)) {
+        w->plotObjectDestroyed(this);
+    }
+}
 
 KPlotObject::PlotTypes KPlotObject::plotTypes() const
 {
@@ -67,6 +643,7 @@ void KPlotObject::setShowPoints(bool b)
     } else {
         d->type &= ~KPlotObject::Points;
     }
+    d->styleChanged();
 }
 
 void KPlotObject::setShowLines(bool b)
@@ -76,6 +653,7 @@ void KPlotObject::setShowLines(bool b)
     } else {
         d->type &= ~KPlotObject::Lines;
     }
+    d->styleChanged();
 }
 
 void KPlotObject::setShowBars(bool b)
@@ -85,6 +663,7 @@ void KPlotObject::setShowBars(bool b)
     } else {
         d->type &= ~KPlotObject::Bars;
     }
+    d->styleChanged();
 }
 
 double KPlotObject::size() const
@@ -95,6 +674,18 @@ double KPlotObject::size() const
 void KPlotObject::setSize(double s)
 {
     d->size = s;
+    d->styleChanged();
+}
+
+double KPlotObject::pointDensityLimit() const
+{
+    return d->pointDensityLimit;
+}
+
+void KPlotObject::setPointDensityLimit(double limit)
+{
+    d->pointDensityLimit = limit;
+    d->styleChanged();
 }
 
 KPlotObject::PointStyle KPlotObject::pointStyle() const
@@ -105,6 +696,7 @@ KPlotObject::PointStyle KPlotObject::pointStyle() const
 void KPlotObject::setPointStyle(PointStyle p)
 {
     d->pointStyle = p;
+    d->styleChanged();
 }
 
 const QPen &KPlotObject::pen() const
@@ -115,6 +707,7 @@ const QPen &KPlotObject::pen() const
 void KPlotObject::setPen(const QPen &p)
 {
     d->pen = p;
+    d->styleChanged();
 }
 
 const QPen &KPlotObject::linePen() const
@@ -125,6 +718,7 @@ const QPen &KPlotObject::linePen() const
 void KPlotObject::setLinePen(const QPen &p)
 {
     d->linePen = p;
+    d->styleChanged();
 }
 
 const QPen &KPlotObject::barPen() const
@@ -135,6 +729,7 @@ const QPen &KPlotObject::barPen() const
 void KPlotObject::setBarPen(const QPen &p)
 {
     d->barPen = p;
+    d->styleChanged();
 }
 
 const QPen &KPlotObject::labelPen() const
@@ -145,6 +740,7 @@ const QPen &KPlotObject::labelPen() const
 void KPlotObject::setLabelPen(const QPen &p)
 {
     d->labelPen = p;
+    d->styleChanged();
 }
 
 const QBrush KPlotObject::brush() const
@@ -155,6 +751,7 @@ const QBrush KPlotObject::brush() const
 void KPlotObject::setBrush(const QBrush &b)
 {
     d->brush = b;
+    d->styleChanged();
 }
 
 const QBrush KPlotObject::barBrush() const
@@ -165,16 +762,138 @@ const QBrush KPlotObject::barBrush() const
 void KPlotObject::setBarBrush(const QBrush &b)
 {
     d->barBrush = b;
+    d->styleChanged();
+}
+
+QList<double> KPlotObject::pointValues() const
+{
+    return d->pointValues;
+}
+
+void KPlotObject::setPointValues(const QList<double> &values)
+{
+    d->pointValues = values;
+    d->styleChanged();
+}
+
+QList<double> KPlotObject::pointSizes() const
+{
+    return d->pointSizes;
+}
+
+void KPlotObject::setPointSizes(const QList<double> &sizes)
+{
+    d->pointSizes = sizes;
+    d->maxPointSize = sizes.isEmpty() ? 0.0 : *std::max_element(sizes.cbegin(), sizes.cend());
+    d->styleChanged();
+}
+
+QList<QColor> KPlotObject::colorTable() const
+{
+    return d->colorTable;
+}
+
+void KPlotObject::setColorTable(const QList<QColor> &colors)
+{
+    d->colorTable = colors;
+    d->styleChanged();
+}
+
+double KPlotObject::minimumValue() const
+{
+    return d->minimumValue;
+}
+
+double KPlotObject::maximumValue() const
+{
+    return d->maximumValue;
+}
+
+void KPlotObject::setValueRange(double min, double max)
+{
+    d->minimumValue = min;
+    d->maximumValue = max;
+    d->styleChanged();
+}
+
+QRectF KPlotObject::boundingRect() const
+{
+    double x1, x2, y1, y2;
+    if (!d->extents(&x1, &x2, &y1, &y2)) {
+        return QRectF();
+    }
+    return QRectF(QPointF(x1, y1), QPointF(x2, y2));
+}
+
+bool KPlotObject::isSortedByX() const
+{
+    d->syncColumns();
+    return d->sortedX;
 }
 
 QList<KPlotPoint *> KPlotObject::points() const
 {
+    d->makeExplicit();
     return d->pList;
 }
 
+void KPlotObject::setUniformSamples(double x0, double dx, const QList<double> &ys)
+{
+    qDeleteAll(d->pList);
+    d->pList.clear();
+    qDeleteAll(d->samplePoints);
+    d->samplePoints.clear();
+    d->xColumn.clear();
+    d->logXColumn.clear();
+    d->logYColumn.clear();
+    d->pointValues.clear();
+    d->pointSizes.clear();
+    d->maxPointSize = 0.0;
+    d->yColumn = ys;
+    d->uniformX = true;
+    d->x0 = x0;
+    d->dx = dx;
+    d->sortedX = dx > 0.0;
+    d->maxBarWidth = 0.0;
+    d->labelCount = 0;
+    d->labelColumn.clear();
+    d->barWidthColumn.clear();
+    d->extentsValid = false;
+    d->mappedValid = false;
+    d->changed();
+}
+
+void KPlotObject::appendSamples(const QList<double> &ys)
+{
+    if (!d->uniformX || ys.isEmpty()) {
+        return;
+    }
+    const qsizetype first = d->yColumn.size();
+    d->yColumn.reserve(first + ys.size());
+    for (double y : ys) {
+        d->appendSample(y);
+    }
+    d->pointsAppended(first);
+}
+
+bool KPlotObject::isUniformlySampled() const
+{
+    return d->uniformX;
+}
+
+double KPlotObject::sampleStart() const
+{
+    return d->uniformX ? d->x0 : 0.0;
+}
+
+double KPlotObject::sampleInterval() const
+{
+    return d->uniformX ? d->dx : 0.0;
+}
+
 void KPlotObject::addPoint(const QPointF &p, const QString &label, double barWidth)
 {
-    addPoint(new KPlotPoint(p.x(), p.y(), label, barWidth));
+    addPoint(p.x(), p.y(), label, barWidth);
 }
 
 void KPlotObject::addPoint(KPlotPoint *p)
@@ -182,186 +901,672 @@ void KPlotObject::addPoint(KPlotPoint *p)
     if (!p) {
         return;
     }
+    if (p->label().isEmpty() && p->barWidth() == 0.0 && d->isNextSample(p->x())) {
+        // p stands for the new sample, until the object is made explicit
+        const qsizetype first = d->count();
+        Private::setOwner(p, this);
+        d->samplePoints.insert(first, p);
+        d->appendSample(p->y());
+        d->pointsAppended(first);
+        return;
+    }
+    d->makeExplicit();
+    Private::setOwner(p, this);
     d->pList.append(p);
+    d->appendColumns(p);
+    d->pointsAppended(d->pList.size() - 1);
 }
 
 void KPlotObject::addPoint(double x, double y, const QString &label, double barWidth)
 {
+    if (label.isEmpty() && barWidth == 0.0 && d->isNextSample(x)) {
+        const qsizetype first = d->count();
+        d->appendSample(y);
+        d->pointsAppended(first);
+        return;
+    }
     addPoint(new KPlotPoint(x, y, label, barWidth));
 }
 
 void KPlotObject::removePoint(int index)
 {
-    if ((index < 0) || (index >= d->pList.count())) {
+    if ((index < 0) || (index >= d->count())) {
         // qWarning() << "KPlotObject::removePoint(): index " << index << " out of range!";
         return;
     }
+    d->syncColumns();
 
-    d->pList.removeAt(index);
+    // Uniform samples stay uniform when trimmed at either end
+    if (d->uniformX && index > 0 && index < d->count() - 1) {
+        d->makeExplicit();
+    }
+
+    // Only a point on the edge of the extents can shrink them.  Trimming
+    // uniform samples moves the x extents to the next sample, unless that
+    // or the trimmed one is not finite.
+    const double x = d->xAt(index);
+    const double y = d->yColumn.at(index);
+    const qsizetype next = index == 0 ? 1 : index - 1;
+    if (d->uniformX && next < d->count() && qIsFinite(y) && qIsFinite(d->yColumn.at(next)) && y != d->minY && y != d->maxY) {
+        if (x == d->minX) {
+            d->minX = d->xAt(next);
+        } else if (x == d->maxX) {
+            d->maxX = d->xAt(next);
+        }
+    } else if (x == d->minX || x == d->maxX || y == d->minY || y == d->maxY) {
+        d->extentsValid = false;
+    }
+    if (d->uniformX) {
+        // A point handed out for the sample is not deleted
+        if (KPlotPoint *p = d->samplePoints.take(index)) {
+            Private::setOwner(p, nullptr);
+        }
+        if (index == 0) {
+            d->x0 += d->dx;
+            QHash<qsizetype, KPlotPoint *> shifted;
+            for (auto it = d->samplePoints.constBegin(); it != d->samplePoints.constEnd(); ++it) {
+                shifted.insert(it.key() - 1, it.value());
+            }
+            d->samplePoints.swap(shifted);
+        }
+    } else {
+        if (!d->pList.at(index)->label().isEmpty()) {
+            --d->labelCount;
+        }
+        // The point is not deleted, and its edits no longer concern us
+        Private::setOwner(d->pList.takeAt(index), nullptr);
+        d->xColumn.removeAt(index);
+    }
+    // QList removes its first item by moving its start, so trimming the
+    // oldest point of a rolling window takes constant time
+    d->yColumn.removeAt(index);
+    if (index < d->logXColumn.size()) {
+        d->logXColumn.removeAt(index);
+    }
+    if (index < d->logYColumn.size()) {
+        d->logYColumn.removeAt(index);
+    }
+    if (index < d->pointValues.size()) {
+        d->pointValues.removeAt(index);
+    }
+    if (index < d->pointSizes.size()) {
+        d->pointSizes.removeAt(index);
+    }
+    if (index < d->labelColumn.size()) {
+        d->labelColumn.removeAt(index);
+    }
+    if (index < d->barWidthColumn.size()) {
+        d->barWidthColumn.removeAt(index);
+    }
+    d->mappedValid = false;
+    d->changed();
 }
 
 void KPlotObject::clearPoints()
 {
     qDeleteAll(d->pList);
     d->pList.clear();
+    qDeleteAll(d->samplePoints);
+    d->samplePoints.clear();
+    d->pointValues.clear();
+    d->pointSizes.clear();
+    d->maxPointSize = 0.0;
+    d->uniformX = false;
+    d->rebuildColumns();
+    d->changed();
+}
+
+void KPlotObject::pointsChanged()
+{
+    d->rebuildColumns();
+    d->changed();
+}
+
+void KPlotObject::beginUpdate()
+{
+    ++d->updateDepth;
+}
+
+void KPlotObject::endUpdate()
+{
+    if (d->updateDepth == 0 || --d->updateDepth > 0) {
+        return;
+    }
+    if (d->notifyPending) {
+        d->notifyPending = false;
+        d->notifyWidgets(d->pendingFirst);
+    }
+}
+
+bool KPlotObject::isUpdating() const
+{
+    return d->updateDepth > 0;
+}
+
+qsizetype KPlotObject::sampleQueueCapacity() const
+{
+    return d->sampleQueue ? d->sampleQueue->capacity() : 0;
+}
+
+void KPlotObject::setSampleQueueCapacity(qsizetype capacity)
+{
+    if (capacity <= 0) {
+        d->sampleQueue.reset();
+    } else {
+        d->sampleQueue.reset(new KPlotSampleQueue(capacity));
+    }
+    for (KPlotWidget *w : std::as_const(d->widgets)) {
+        w->sampleQueueChanged();
+    }
+}
+
+bool KPlotObject::pushSample(double x, double y)
+{
+    return d->sampleQueue && d->sampleQueue->push(x, y);
+}
+
+qsizetype KPlotObject::takeSamples()
+{
+    if (!d->sampleQueue || d->sampleQueue->isEmpty()) {
+        return 0;
+    }
+    const qsizetype first = d->count();
+    const qsizetype n = d->sampleQueue->consume([this](const QPointF &p) {
+        // Samples continuing uniform ones stay uniform
+        if (d->isNextSample(p.x())) {
+            d->appendSample(p.y());
+            return;
+        }
+        d->makeExplicit();
+        KPlotPoint *point = new KPlotPoint(p.x(), p.y());
+        Private::setOwner(point, this);
+        d->pList.append(point);
+        d->appendColumns(point);
+    });
+    d->pointsAppended(first);
+    return n;
 }
 
 void KPlotObject::draw(QPainter *painter, KPlotWidget *pw)
 {
-    // Order of drawing determines z-distance: Bars in the back, then lines,
-    // then points, then labels.
+    draw(painter, pw->renderer());
+}
 
-    if (d->type & Bars) {
-        painter->setPen(barPen());
-        painter->setBrush(barBrush());
+void KPlotObject::draw(QPainter *painter, KPlotRenderer *renderer)
+{
+    const KPlotTransform &t = renderer->d->transform;
+    d->draw(painter, &renderer->d->mask, t, t.dataRect().left(), t.dataRect().right());
+}
 
+void KPlotObject::Private::draw(QPainter *painter, KPlotMask *mask, const KPlotTransform &t, double fromX, double toX)
+{
+    syncColumns();
+    // Only drawings of the whole plot are kept; strips and tiles of it
+    // would just replace each other
+    const bool whole = fromX <= t.dataRect().left() && toX >= t.dataRect().right();
+    if (whole && displayList.valid && displayList.revision == revision && displayList.transform == t) {
+        replay(painter, mask, displayList);
+        return;
+    }
+
+    qsizetype first;
+    qsizetype last;
+    visibleRange(fromX, toX, &first, &last);
+    mapPoints(t, first, last);
+    updateViewCount(t);
+    if (!whole) {
+        paint(painter, mask, t, fromX, toX);
+        return;
+    }
+
+    displayList = DisplayList();
+    record(&displayList, t, fromX, toX);
+    displayList.transform = t;
+    displayList.revision = revision;
+    displayList.valid = true;
+    replay(painter, mask, displayList);
+}
+
+void KPlotObject::Private::paint(QPainter *painter, KPlotMask *mask, const KPlotTransform &t, double fromX, double toX) const
+{
+    DisplayList list;
+    record(&list, t, fromX, toX);
+    replay(painter, mask, list);
+}
+
+void KPlotObject::Private::record(DisplayList *list, const KPlotTransform &t, double fromX, double toX) const
+{
+    // Only the points in [first, last) can be visible
+    qsizetype first;
+    qsizetype last;
+    visibleRange(fromX, toX, &first, &last);
+    const QPointF *mapped = mappedPoints.constData();
+    const QRect pixRect = t.pixRect();
+
+    if (type & Bars) {
+        // On a logarithmic y axis, bars start at the bottom of the plot
+        const double y0 = t.isLogY() ? t.dataRect().top() : 0.0;
+
+        // Bars can reach into the plot from points outside of it
+        qsizetype firstBar;
+        qsizetype lastBar;
+        visibleRange(fromX - 0.5 * maxBarWidth, toX + 0.5 * maxBarWidth, &firstBar, &lastBar);
+
+        // Uniformly sampled bars fill the sampling interval
+        auto barWidth = [this](qsizetype i) {
+            return i < barWidthColumn.size() ? barWidthColumn[i] : 0.0;
+        };
+        const qsizetype n = count();
+
+        // The width of the last bar is taken from the previous one
         double w = 0;
-        for (int i = 0; i < d->pList.size(); ++i) {
-            if (d->pList[i]->barWidth() == 0.0) {
-                if (i < d->pList.size() - 1) {
-                    w = d->pList[i + 1]->x() - d->pList[i]->x();
+        if (firstBar > 0) {
+            const double bw = barWidth(firstBar - 1);
+            w = bw == 0.0 ? xAt(firstBar) - xAt(firstBar - 1) : bw;
+        }
+
+        for (qsizetype i = firstBar; i < lastBar; ++i) {
+            if (barWidth(i) == 0.0) {
+                if (i < n - 1) {
+                    w = xAt(i + 1) - xAt(i);
                 }
                 // For the last bin, we'll just keep the previous width
 
             } else {
-                w = d->pList[i]->barWidth();
+                w = barWidth(i);
             }
 
-            QPointF pp = d->pList[i]->position();
-            QPointF p1(pp.x() - 0.5 * w, 0.0);
-            QPointF p2(pp.x() + 0.5 * w, pp.y());
-            QPointF sp1 = pw->mapToWidget(p1);
-            QPointF sp2 = pw->mapToWidget(p2);
+            const double x = xAt(i);
+            QPointF sp1 = t.map(QPointF(x - 0.5 * w, y0));
+            QPointF sp2 = t.map(QPointF(x + 0.5 * w, yColumn[i]));
+            if (!qIsFinite(sp1.x()) || !qIsFinite(sp1.y()) || !qIsFinite(sp2.x()) || !qIsFinite(sp2.y())) {
+                continue;
+            }
 
-            QRectF barRect = QRectF(sp1.x(), sp1.y(), sp2.x() - sp1.x(), sp2.y() - sp1.y()).normalized();
-            painter->drawRect(barRect);
-            pw->maskRect(barRect, 0.25);
+            list->bars.append(QRectF(sp1.x(), sp1.y(), sp2.x() - sp1.x(), sp2.y() - sp1.y()).normalized());
         }
     }
 
-    // Draw lines:
-    if (d->type & Lines) {
-        painter->setPen(linePen());
+    if (type & Lines) {
+        // Points that cannot be mapped (non-positive values on a
+        // logarithmic axis) interrupt the line.
+        bool havePrevious = false;
+        QPointF Previous;
 
-        QPointF Previous = QPointF(); // Initialize to null
+        const QRectF visibleRect(t.pixRect());
+        // The scaled columns are up to date after mapPoints()
+        const bool logX = t.isLogX();
+        const double *sy = (t.isLogY() ? logYColumn : yColumn).constData();
+
+        // Consecutive segments are joined into polylines
+        auto addSegment = [list](const QPointF &p1, const QPointF &p2) {
+            if (list->lineRuns.isEmpty() || list->linePoints.last() != p1) {
+                list->linePoints.append(p1);
+                list->lineRuns.append(1);
+            }
+            list->linePoints.append(p2);
+            ++list->lineRuns.last();
+        };
 
-        for (const KPlotPoint *pp : std::as_const(d->pList)) {
+        for (qsizetype i = first; i < last; ++i) {
             // q is the position of the point in screen pixel coordinates
-            QPointF q = pw->mapToWidget(pp->position());
+            const QPointF &q = mapped[i];
+            if (!qIsFinite(q.x()) || !qIsFinite(q.y())) {
+                havePrevious = false;
+                continue;
+            }
 
-            if (!Previous.isNull()) {
-                painter->drawLine(Previous, q);
-                pw->maskAlongLine(Previous, q);
+            if (havePrevious) {
+                if (visibleRect.contains(Previous) && visibleRect.contains(q)) {
+                    addSegment(Previous, q);
+                } else {
+                    // Clip segments leaving the plot in data space, so that
+                    // deep zooms don't produce huge pixel coordinates
+                    QPointF s1(scaledXAt(i - 1, logX), sy[i - 1]);
+                    QPointF s2(scaledXAt(i, logX), sy[i]);
+                    if (t.clipScaled(&s1, &s2)) {
+                        addSegment(t.mapScaled(s1), t.mapScaled(s2));
+                    }
+                }
             }
 
             Previous = q;
+            havePrevious = true;
         }
     }
 
-    // Draw points:
-    if (d->type & Points) {
-        for (const KPlotPoint *pp : std::as_const(d->pList)) {
-            // q is the position of the point in screen pixel coordinates
-            QPointF q = pw->mapToWidget(pp->position());
-            if (pw->pixRect().contains(q.toPoint(), false)) {
-                double x1 = q.x() - size();
-                double y1 = q.y() - size();
-                QRectF qr = QRectF(x1, y1, 2 * size(), 2 * size());
+    const bool letters = pointStyle == Letter && labelCount > 0;
+    const bool colors = !colorTable.isEmpty() && !pointValues.isEmpty();
+    const bool sizes = !pointSizes.isEmpty();
+    for (qsizetype i = first; i < last; ++i) {
+        const QPointF &q = mapped[i];
+        if (!qIsFinite(q.x()) || !qIsFinite(q.y()) || !pixRect.contains(q.toPoint(), false)) {
+            continue;
+        }
+        if (type & Points) {
+            list->markers.append(q);
+            if (letters) {
+                list->letters.append(i < labelColumn.size() ? labelColumn[i].left(1) : QString());
+            }
+            if (colors) {
+                list->markerColors.append(colorIndex(i));
+            }
+            if (sizes) {
+                list->markerSizes.append(i < pointSizes.size() ? pointSizes[i] : size);
+            }
+        }
+        if (i < labelColumn.size() && !labelColumn[i].isEmpty()) {
+            list->labelAnchors.append(q);
+            list->labels.append(labelColumn[i]);
+        }
+    }
 
-                // Mask out this rect in the plot for label avoidance
-                pw->maskRect(qr, 2.0);
-
-                painter->setPen(pen());
-                painter->setBrush(brush());
-
-                switch (pointStyle()) {
-                case Circle:
-                    painter->drawEllipse(qr);
-                    break;
-
-                case Letter:
-                    painter->drawText(qr, Qt::AlignCenter, pp->label().left(1));
-                    break;
-
-                case Triangle: {
-                    QPolygonF tri;
-                    /* clang-format off */
-                    tri << QPointF(q.x() - size(), q.y() + size())
-                        << QPointF(q.x(), q.y() - size())
-                        << QPointF(q.x() + size(), q.y() + size());
-                    /* clang-format on */
-                    painter->drawPolygon(tri);
-                    break;
-                }
+    if (!list->markers.isEmpty() && pointStyle != Letter && dense(t)) {
+        collapseMarkers(list, pixRect, size >= 2.0 ? 2 : 1);
+    }
+}
 
-                case Square:
-                    painter->drawRect(qr);
-                    break;
-
-                case Pentagon: {
-                    QPolygonF pent;
-                    /* clang-format off */
-                    pent << QPointF(q.x(), q.y() - size())
-                         << QPointF(q.x() + size(), q.y() - 0.309 * size())
-                         << QPointF(q.x() + 0.588 * size(), q.y() + size())
-                         << QPointF(q.x() - 0.588 * size(), q.y() + size())
-                         << QPointF(q.x() - size(), q.y() - 0.309 * size());
-                    /* clang-format on */
-                    painter->drawPolygon(pent);
-                    break;
-                }
+bool KPlotObject::Private::dense(const KPlotTransform &t) const
+{
+    if (pointDensityLimit <= 0.0) {
+        return false;
+    }
+    // Counted over the whole view, so that strips and tiles of it agree
+    qsizetype n;
+    double markerSize;
+    if (viewCount.valid && viewCount.revision == revision && viewCount.transform == t) {
+        n = viewCount.n;
+        markerSize = viewCount.markerSize;
+    } else {
+        countInView(t, &n, &markerSize);
+    }
+    const double area = double(t.pixRect().width()) * t.pixRect().height();
+    return n * (2.0 * markerSize) * (2.0 * markerSize) > pointDensityLimit * area;
+}
 
-                case Hexagon: {
-                    QPolygonF hex;
-                    /* clang-format off */
-                    hex << QPointF(q.x(), q.y() + size())
-                        << QPointF(q.x() + size(), q.y() + 0.5 * size())
-                        << QPointF(q.x() + size(), q.y() - 0.5 * size())
-                        << QPointF(q.x(), q.y() - size())
-                        << QPointF(q.x() - size(), q.y() + 0.5 * size())
-                        << QPointF(q.x() - size(), q.y() - 0.5 * size());
-                    /* clang-format on */
-                    painter->drawPolygon(hex);
-                    break;
-                }
+void KPlotObject::Private::countInView(const KPlotTransform &t, qsizetype *n, double *markerSize) const
+{
+    const QRectF r = t.dataRect();
+    const double x1 = qMin(r.left(), r.right());
+    const double x2 = qMax(r.left(), r.right());
+    const double y1 = qMin(r.top(), r.bottom());
+    const double y2 = qMax(r.top(), r.bottom());
+    qsizetype first;
+    qsizetype last;
+    visibleRange(x1, x2, &first, &last);
+    *n = 0;
+    // Taking every marker as large as the largest one of them
+    *markerSize = size;
+    for (qsizetype i = first; i < last; ++i) {
+        const double x = xAt(i);
+        const double y = yColumn[i];
+        if (!(x >= x1 && x <= x2 && y >= y1 && y <= y2)) {
+            continue;
+        }
+        ++*n;
+        if (i < pointSizes.size()) {
+            *markerSize = qMax(*markerSize, pointSizes[i]);
+        }
+    }
+}
 
-                case Asterisk:
-                    painter->drawLine(q, QPointF(q.x(), q.y() + size()));
-                    painter->drawLine(q, QPointF(q.x() + size(), q.y() + 0.5 * size()));
-                    painter->drawLine(q, QPointF(q.x() + size(), q.y() - 0.5 * size()));
-                    painter->drawLine(q, QPointF(q.x(), q.y() - size()));
-                    painter->drawLine(q, QPointF(q.x() - size(), q.y() + 0.5 * size()));
-                    painter->drawLine(q, QPointF(q.x() - size(), q.y() - 0.5 * size()));
-                    break;
-
-                case Star: {
-                    QPolygonF star;
-                    /* clang-format off */
-                    star << QPointF(q.x(), q.y() - size())
-                         << QPointF(q.x() + 0.2245 * size(), q.y() - 0.309 * size())
-                         << QPointF(q.x() + size(), q.y() - 0.309 * size()) << QPointF(q.x() + 0.363 * size(), q.y() + 0.118 * size())
-                         << QPointF(q.x() + 0.588 * size(), q.y() + size()) << QPointF(q.x(), q.y() + 0.382 * size())
-                         << QPointF(q.x() - 0.588 * size(), q.y() + size()) << QPointF(q.x() - 0.363 * size(), q.y() + 0.118 * size())
-                         << QPointF(q.x() - size(), q.y() - 0.309 * size()) << QPointF(q.x() - 0.2245 * size(), q.y() - 0.309 * size());
-                    /* clang-format on */
-                    painter->drawPolygon(star);
-                    break;
-                }
+void KPlotObject::Private::updateViewCount(const KPlotTransform &t)
+{
+    if (pointDensityLimit <= 0.0 || (viewCount.valid && viewCount.revision == revision && viewCount.transform == t)) {
+        return;
+    }
+    countInView(t, &viewCount.n, &viewCount.markerSize);
+    viewCount.revision = revision;
+    viewCount.transform = t;
+    viewCount.valid = true;
+}
+
+void KPlotObject::Private::collapseMarkers(DisplayList *list, const QRect &pixRect, int dotSize)
+{
+    // One bit for each dot of the plot area, set once it is drawn
+    const int columns = pixRect.width() / dotSize + 1;
+    const int rows = pixRect.height() / dotSize + 1;
+    QBitArray occupied(columns * rows);
+
+    for (qsizetype i = 0; i < list->markers.size(); ++i) {
+        const QPointF &q = list->markers[i];
+        // The pixel containing q; the painter is offset by half a pixel
+        const int column = (int(floor(q.x() + 0.5)) - pixRect.left()) / dotSize;
+        const int row = (int(floor(q.y() + 0.5)) - pixRect.top()) / dotSize;
+        if (column < 0 || column >= columns || row < 0 || row >= rows || occupied.testBit(row * columns + column)) {
+            continue;
+        }
+        occupied.setBit(row * columns + column);
+        list->dots.append(QRectF(pixRect.left() + column * dotSize - 0.5, pixRect.top() + row * dotSize - 0.5, dotSize, dotSize));
+        if (!list->markerColors.isEmpty()) {
+            list->dotColors.append(list->markerColors[i]);
+        }
+    }
+    list->markers.clear();
+    list->markerColors.clear();
+    list->markerSizes.clear();
+}
+
+int KPlotObject::Private::colorIndex(qsizetype i) const
+{
+    if (i >= pointValues.size() || !qIsFinite(pointValues[i])) {
+        return -1;
+    }
+    const double range = maximumValue - minimumValue;
+    const double f = range == 0.0 ? 0.0 : qBound(0.0, (pointValues[i] - minimumValue) / range, 1.0);
+    return qMin(int(f * colorTable.size()), int(colorTable.size()) - 1);
+}
+
+void KPlotObject::Private::groupByColor(const QList<int> &colors, qsizetype n, QList<qsizetype> *order, QList<qsizetype> *starts) const
+{
+    order->clear();
+    if (colors.isEmpty()) {
+        *starts = {0, n};
+        return;
+    }
 
-                default:
-                    break;
+    // Counting sort, keeping the order of drawing within each color
+    starts->fill(0, colorTable.size() + 2);
+    for (int c : colors) {
+        ++(*starts)[c + 2];
+    }
+    for (qsizetype k = 2; k < starts->size(); ++k) {
+        (*starts)[k] += (*starts)[k - 1];
+    }
+    order->resize(n);
+    for (qsizetype i = 0; i < n; ++i) {
+        (*order)[(*starts)[colors[i] + 1]++] = i;
+    }
+    starts->removeLast();
+    starts->prepend(0);
+}
+
+void KPlotObject::Private::drawMarker(QPainter *painter, const QPointF &q, double markerSize, const QString &letter) const
+{
+    const QRectF qr(q.x() - markerSize, q.y() - markerSize, 2 * markerSize, 2 * markerSize);
+
+    switch (pointStyle) {
+    case Circle:
+        painter->drawEllipse(qr);
+        break;
+
+    case Letter:
+        if (!letter.isNull()) {
+            painter->drawText(qr, Qt::AlignCenter, letter);
+        }
+        break;
+
+    case Triangle: {
+        QPolygonF tri;
+        /* clang-format off */
+        tri << QPointF(q.x() - markerSize, q.y() + markerSize)
+            << QPointF(q.x(), q.y() - markerSize)
+            << QPointF(q.x() + markerSize, q.y() + markerSize);
+        /* clang-format on */
+        painter->drawPolygon(tri);
+        break;
+    }
+
+    case Square:
+        painter->drawRect(qr);
+        break;
+
+    case Pentagon: {
+        QPolygonF pent;
+        /* clang-format off */
+        pent << QPointF(q.x(), q.y() - markerSize)
+             << QPointF(q.x() + markerSize, q.y() - 0.309 * markerSize)
+             << QPointF(q.x() + 0.588 * markerSize, q.y() + markerSize)
+             << QPointF(q.x() - 0.588 * markerSize, q.y() + markerSize)
+             << QPointF(q.x() - markerSize, q.y() - 0.309 * markerSize);
+        /* clang-format on */
+        painter->drawPolygon(pent);
+        break;
+    }
+
+    case Hexagon: {
+        QPolygonF hex;
+        /* clang-format off */
+        hex << QPointF(q.x(), q.y() + markerSize)
+            << QPointF(q.x() + markerSize, q.y() + 0.5 * markerSize)
+            << QPointF(q.x() + markerSize, q.y() - 0.5 * markerSize)
+            << QPointF(q.x(), q.y() - markerSize)
+            << QPointF(q.x() - markerSize, q.y() + 0.5 * markerSize)
+            << QPointF(q.x() - markerSize, q.y() - 0.5 * markerSize);
+        /* clang-format on */
+        painter->drawPolygon(hex);
+        break;
+    }
+
+    case Asterisk:
+        painter->drawLine(q, QPointF(q.x(), q.y() + markerSize));
+        painter->drawLine(q, QPointF(q.x() + markerSize, q.y() + 0.5 * markerSize));
+        painter->drawLine(q, QPointF(q.x() + markerSize, q.y() - 0.5 * markerSize));
+        painter->drawLine(q, QPointF(q.x(), q.y() - markerSize));
+        painter->drawLine(q, QPointF(q.x() - markerSize, q.y() + 0.5 * markerSize));
+        painter->drawLine(q, QPointF(q.x() - markerSize, q.y() - 0.5 * markerSize));
+        break;
+
+    case Star: {
+        QPolygonF star;
+        /* clang-format off */
+        star << QPointF(q.x(), q.y() - markerSize)
+             << QPointF(q.x() + 0.2245 * markerSize, q.y() - 0.309 * markerSize)
+             << QPointF(q.x() + markerSize, q.y() - 0.309 * markerSize) << QPointF(q.x() + 0.363 * markerSize, q.y() + 0.118 * markerSize)
+             << QPointF(q.x() + 0.588 * markerSize, q.y() + markerSize) << QPointF(q.x(), q.y() + 0.382 * markerSize)
+             << QPointF(q.x() - 0.588 * markerSize, q.y() + markerSize) << QPointF(q.x() - 0.363 * markerSize, q.y() + 0.118 * markerSize)
+             << QPointF(q.x() - markerSize, q.y() - 0.309 * markerSize) << QPointF(q.x() - 0.2245 * markerSize, q.y() - 0.309 * markerSize);
+        /* clang-format on */
+        painter->drawPolygon(star);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void KPlotObject::Private::replay(QPainter *painter, KPlotMask *mask, const DisplayList &list) const
+{
+    // Order of drawing determines z-distance: Bars in the back, then lines,
+    // then points, then labels.
+
+    if (!list.bars.isEmpty()) {
+        painter->setPen(barPen);
+        painter->setBrush(barBrush);
+        painter->drawRects(list.bars.constData(), list.bars.size());
+        if (mask) {
+            for (const QRectF &r : list.bars) {
+                mask->maskRect(r, 0.25);
+            }
+        }
+    }
+
+    if (!list.lineRuns.isEmpty()) {
+        painter->setPen(linePen);
+        const QPointF *points = list.linePoints.constData();
+        for (int n : list.lineRuns) {
+            painter->drawPolyline(points, n);
+            if (mask) {
+                for (int i = 1; i < n; ++i) {
+                    mask->maskAlongLine(points[i - 1], points[i]);
                 }
             }
+            points += n;
         }
     }
 
-    // Draw labels
-    painter->setPen(labelPen());
+    // Markers and dots are drawn grouped by color, changing the pen and
+    // brush once per group
+    QList<qsizetype> order;
+    QList<qsizetype> starts;
+    auto groupPen = [this](int group) {
+        QPen p(pen);
+        if (group > 0) {
+            p.setColor(colorTable[group - 1]);
+        }
+        return p;
+    };
+    auto groupBrush = [this](int group) {
+        QBrush b(brush);
+        if (group > 0) {
+            b.setColor(colorTable[group - 1]);
+        }
+        return b;
+    };
 
-    for (KPlotPoint *pp : std::as_const(d->pList)) {
-        QPoint q = pw->mapToWidget(pp->position()).toPoint();
-        if (pw->pixRect().contains(q, false) && !pp->label().isEmpty()) {
-            pw->placeLabel(painter, pp);
+    if (!list.markers.isEmpty()) {
+        groupByColor(list.markerColors, list.markers.size(), &order, &starts);
+        for (int group = 0; group + 1 < starts.size(); ++group) {
+            if (starts[group] == starts[group + 1]) {
+                continue;
+            }
+            const QPen markerPen = groupPen(group);
+            const QBrush markerBrush = groupBrush(group);
+            painter->setPen(markerPen);
+            painter->setBrush(markerBrush);
+            for (qsizetype k = starts[group]; k < starts[group + 1]; ++k) {
+                const qsizetype i = order.isEmpty() ? k : order[k];
+                const QPointF &q = list.markers[i];
+                const double markerSize = list.markerSizes.isEmpty() ? size : list.markerSizes[i];
+                const QRectF qr(q.x() - markerSize, q.y() - markerSize, 2 * markerSize, 2 * markerSize);
+                // Mask out this rect in the plot for label avoidance
+                if (mask) {
+                    mask->maskRect(qr, 2.0);
+                }
+                drawMarker(painter, q, markerSize, list.letters.isEmpty() ? QString() : list.letters[i]);
+            }
         }
     }
+
+    if (!list.dots.isEmpty()) {
+        painter->setPen(Qt::NoPen);
+        groupByColor(list.dotColors, list.dots.size(), &order, &starts);
+        QList<QRectF> dots;
+        for (int group = 0; group + 1 < starts.size(); ++group) {
+            if (starts[group] == starts[group + 1]) {
+                continue;
+            }
+            dots.clear();
+            for (qsizetype k = starts[group]; k < starts[group + 1]; ++k) {
+                dots.append(list.dots[order.isEmpty() ? k : order[k]]);
+            }
+            painter->setBrush(QBrush(groupPen(group).color()));
+            painter->drawRects(dots.constData(), dots.size());
+        }
+        if (mask) {
+            for (const QRectF &r : list.dots) {
+                mask->maskRect(r, 2.0);
+            }
+        }
+    }
+
+    // Draw labels
+    if (!mask || list.labels.isEmpty()) {
+        return;
+    }
+    painter->setPen(labelPen);
+    for (qsizetype i = 0; i < list.labels.size(); ++i) {
+        mask->placeLabel(painter, list.labelAnchors[i], list.labels[i]);
+    }
 }
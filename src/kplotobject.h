@@ -11,6 +11,7 @@
 #include <kplotting_export.h>
 
 #include <QColor>
+#include <QList>
 #include <QString>
 
 #include <memory>
@@ -19,8 +20,10 @@ class QBrush;
 class QPainter;
 class QPen;
 class QPointF;
+class QRectF;
 class KPlotWidget;
 class KPlotPoint;
+class KPlotRenderer;
 
 /*!
  * \class KPlotObject
@@ -157,6 +160,41 @@ public:
      */
     void setPointStyle(PointStyle p);
 
+    /*!
+     * Returns the density of points above which they are drawn as dots
+     * instead of markers.
+     *
+     * \sa setPointDensityLimit()
+     *
+     * \since 6.28
+     */
+    double pointDensityLimit() const;
+
+    /*!
+     * Set the density of points above which they are drawn as dots
+     * instead of markers.
+     *
+     * The density is how many times over the markers of the points inside
+     * the plot area would cover it, taking them all as large as the
+     * largest of them (see setPointSizes()).  Points outside of the
+     * limits, in x or in y, are not counted.  Above \a limit, each point
+     * is drawn as a square dot of one pixel (two pixels for a size of 2
+     * or more) in the color of the pen, and points landing on the same
+     * dot are drawn once, so that drawing dense clouds of points costs no
+     * more than filling the plot area.  Points drawn as letters are always
+     * drawn in full.
+     *
+     * A limit of 0 or less always draws markers.  The default is 1, so
+     * plots whose markers cover the plot area more than once are drawn
+     * as dots unless the limit is changed; applications that relied on
+     * markers always being drawn should set a limit of 0.
+     *
+     * \a limit the new density limit
+     *
+     * \since 6.28
+     */
+    void setPointDensityLimit(double limit);
+
     /*!
      * Returns the default pen for this Object.
      *
@@ -232,6 +270,198 @@ public:
      */
     void setBarBrush(const QBrush &b);
 
+    /*!
+     * Returns the values of the points that select their colors from
+     * colorTable().
+     *
+     * \sa setPointValues()
+     *
+     * \since 6.28
+     */
+    QList<double> pointValues() const;
+
+    /*!
+     * Set a value for each point, in the order of points(), which selects
+     * the color of its marker from colorTable().
+     *
+     * The range between minimumValue() and maximumValue() is divided into
+     * as many equal bins as there are colors, and values outside of it
+     * take the color of the nearest end.  Points without a value, or
+     * whose value is not a number, are drawn with pen() and brush(), and
+     * so are all points while the color table is empty.  The markers are
+     * drawn grouped by color.
+     *
+     * The values belong to the points: removing a point removes its
+     * value, and clearPoints() removes them all.
+     *
+     * \a values the values of the points
+     *
+     * \since 6.28
+     */
+    void setPointValues(const QList<double> &values);
+
+    /*!
+     * Returns the sizes of the points, in pixels.
+     *
+     * \sa setPointSizes()
+     *
+     * \since 6.28
+     */
+    QList<double> pointSizes() const;
+
+    /*!
+     * Set the size of the marker of each point, in pixels and in the order
+     * of points().  Points without a size are drawn with size().
+     *
+     * Like the values, the sizes are removed along with their points.
+     *
+     * \a sizes the sizes of the points
+     *
+     * \since 6.28
+     */
+    void setPointSizes(const QList<double> &sizes);
+
+    /*!
+     * Returns the colors that the values of the points are mapped to.
+     *
+     * \sa setPointValues()
+     *
+     * \since 6.28
+     */
+    QList<QColor> colorTable() const;
+
+    /*!
+     * Set the colors that the values of the points are mapped to, from
+     * the color of minimumValue() to the color of maximumValue().
+     *
+     * The pen and brush of a colored marker are pen() and brush() with
+     * their color replaced.
+     *
+     * \a colors the lookup table of colors
+     *
+     * \since 6.28
+     */
+    void setColorTable(const QList<QColor> &colors);
+
+    /*!
+     * Returns the value mapped to the first color of colorTable().
+     *
+     * \since 6.28
+     */
+    double minimumValue() const;
+
+    /*!
+     * Returns the value mapped to the last color of colorTable().
+     *
+     * \since 6.28
+     */
+    double maximumValue() const;
+
+    /*!
+     * Set the range of point values spread over colorTable().  The
+     * default range is from 0 to 1.
+     *
+     * \a min the value mapped to the first color
+     *
+     * \a max the value mapped to the last color
+     *
+     * \since 6.28
+     */
+    void setValueRange(double min, double max);
+
+    /*!
+     * Returns the smallest rectangle, in data units, that contains the
+     * points of this object, or a null rectangle if it has none.
+     *
+     * Points with an infinite or NaN coordinate are left out.  The
+     * rectangle is kept up to date as points are added, so this is cheap
+     * to call after each change, see KPlotWidget::setAutoScaling().
+     *
+     * \since 6.28
+     */
+    QRectF boundingRect() const;
+
+    /*!
+     * Returns whether the points of this object are in order of
+     * non-decreasing x-coordinate.
+     *
+     * This is detected as points are added.  For sorted objects, drawing
+     * and hit-testing only visit the points inside the visible x-range,
+     * so zooming into a part of a long series is cheap.
+     *
+     * \since 6.28
+     */
+    bool isSortedByX() const;
+
+    /*!
+     * Replace the points of this object with uniformly sampled values:
+     * point i is at (x0 + i * dx, ys[i]).
+     *
+     * Only the y-values are stored, without a KPlotPoint or an
+     * x-coordinate for each sample, which is a fraction of the memory of
+     * adding the points one by one.  With a positive \a dx, the points
+     * inside the visible x-range are found by arithmetic.
+     *
+     * Points added with addPoint() or taken from pushed samples stay
+     * uniform samples if they have no label or bar width and continue the
+     * x-coordinates, to within a millionth of \a dx.  The points found by
+     * KPlotRenderer::pointsUnderPoint() and KPlotRenderer::nearestPoint()
+     * are created on their own.  The object switches to storing all of
+     * its points explicitly when calling points(), adding any other
+     * point, editing a point, or removing a point other than the first or
+     * the last one.  Point values and sizes are cleared.
+     *
+     * \a x0 the x-coordinate of the first sample
+     *
+     * \a dx the distance between the x-coordinates of consecutive samples
+     *
+     * \a ys the y-coordinates of the samples
+     *
+     * \sa appendSamples(), isUniformlySampled()
+     *
+     * \since 6.28
+     */
+    void setUniformSamples(double x0, double dx, const QList<double> &ys);
+
+    /*!
+     * Append samples to a uniformly sampled object, continuing its
+     * x-coordinates.  Does nothing if the object is not uniformly sampled.
+     *
+     * \a ys the y-coordinates of the new samples
+     *
+     * \sa setUniformSamples()
+     *
+     * \since 6.28
+     */
+    void appendSamples(const QList<double> &ys);
+
+    /*!
+     * Returns whether the points of this object are stored as uniformly
+     * sampled values.
+     *
+     * \sa setUniformSamples()
+     *
+     * \since 6.28
+     */
+    bool isUniformlySampled() const;
+
+    /*!
+     * Returns the x-coordinate of the first sample of a uniformly sampled
+     * object, or 0 if it is not uniformly sampled.
+     *
+     * \since 6.28
+     */
+    double sampleStart() const;
+
+    /*!
+     * Returns the distance between the x-coordinates of consecutive
+     * samples of a uniformly sampled object, or 0 if it is not uniformly
+     * sampled.
+     *
+     * \since 6.28
+     */
+    double sampleInterval() const;
+
     /*!
      * Returns the list of KPlotPoints that make up this object
      */
@@ -290,6 +520,110 @@ public:
      */
     void clearPoints();
 
+    /*!
+     * Notify the object that KPlotPoints returned by points() were
+     * modified in place, and repaint the widgets showing it.
+     *
+     * KPlotObject keeps its own copies of the point coordinates (and of
+     * their logarithms, for logarithmic axes) for drawing.  Points edited
+     * through their setters mark these out of date, and they are rebuilt
+     * when they are next needed, so calling this is only necessary to
+     * repaint the widgets right away.
+     *
+     * \since 6.28
+     */
+    void pointsChanged();
+
+    /*!
+     * Start a batch of changes to the object.
+     *
+     * Until the matching endUpdate(), the widgets showing the object are
+     * not told about changes, so that adding many points or changing
+     * several style settings schedules a single repaint, of everything
+     * that changed, when the batch ends.  Calls can be nested; only the
+     * outermost endUpdate() ends the batch.
+     *
+     * \sa endUpdate(), isUpdating(), KPlotWidget::beginUpdate()
+     * \since 6.28
+     */
+    void beginUpdate();
+
+    /*!
+     * End a batch of changes started with beginUpdate(), and let the
+     * widgets showing the object repaint what changed during it.
+     *
+     * \sa beginUpdate()
+     * \since 6.28
+     */
+    void endUpdate();
+
+    /*!
+     * Returns whether a batch of changes started with beginUpdate() has
+     * not ended yet.
+     *
+     * \since 6.28
+     */
+    bool isUpdating() const;
+
+    /*!
+     * Returns the number of samples that the sample queue holds, or 0 if
+     * the object has none.
+     *
+     * \sa setSampleQueueCapacity()
+     * \since 6.28
+     */
+    qsizetype sampleQueueCapacity() const;
+
+    /*!
+     * Give the object a queue of samples that another thread can append
+     * points to, or remove it.
+     *
+     * The queue lets an acquisition thread feed the object without locks
+     * or events: that thread calls pushSample(), and the thread owning the
+     * object takes the samples as new points with takeSamples().  Widgets
+     * showing the object take them at their frame rate, see
+     * KPlotWidget::setMaximumFrameRate().
+     *
+     * This must not be called while samples are being pushed.  Samples
+     * still queued are dropped.
+     *
+     * \a capacity the number of samples the queue holds, which is rounded
+     * up to a power of two, or 0 to remove the queue
+     *
+     * \sa pushSample(), takeSamples()
+     * \since 6.28
+     */
+    void setSampleQueueCapacity(qsizetype capacity);
+
+    /*!
+     * Queue a sample to be added as a point by takeSamples().
+     *
+     * Unlike the other functions of KPlotObject, this can be called from
+     * another thread, as long as only one thread pushes samples at a time.
+     * It does not lock or allocate.
+     *
+     * Returns false, dropping the sample, if the object has no sample queue
+     * or the queue is full.
+     *
+     * \a x the X-coordinate of the sample
+     *
+     * \a y the Y-coordinate of the sample
+     *
+     * \sa setSampleQueueCapacity()
+     * \since 6.28
+     */
+    bool pushSample(double x, double y);
+
+    /*!
+     * Add the queued samples as points, in the order they were pushed.
+     *
+     * Returns the number of points added.
+     *
+     * \sa pushSample()
+     * \since 6.28
+     */
+    qsizetype takeSamples();
+
     /*!
      * Draw this KPlotObject on the given QPainter
      *
@@ -300,7 +634,25 @@ public:
      */
     void draw(QPainter *p, KPlotWidget *pw);
 
+    /*!
+     * Draw this KPlotObject on the given QPainter
+     *
+     * \overload
+     *
+     * \a p The QPainter to draw on
+     *
+     * \a renderer the KPlotRenderer of the plot to draw in, which maps
+     * the points to pixels and places the labels
+     *
+     * \since 6.28
+     */
+    void draw(QPainter *p, KPlotRenderer *renderer);
+
 private:
+    friend class KPlotPoint;
+    friend class KPlotRenderer;
+    friend class KPlotWidget;
+
     class Private;
     std::unique_ptr<Private> const d;
 
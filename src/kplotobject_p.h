@@ -0,0 +1,302 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2003 Jason Harris <kstars@30doradus.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KPLOTOBJECT_P_H
+#define KPLOTOBJECT_P_H
+
+#include "kplotobject.h"
+#include "kplotsamplequeue_p.h"
+#include "kplottransform_p.h"
+
+#include <QBrush>
+#include <QHash>
+#include <QList>
+#include <QPen>
+#include <QPoint>
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+#include <QStringList>
+
+#include <math.h>
+
+#include <memory>
+
+class KPlotMask;
+
+class KPlotObject::Private
+{
+public:
+    Private(KPlotObject *qq)
+        : q(qq)
+    {
+    }
+
+    ~Private()
+    {
+        qDeleteAll(pList);
+        qDeleteAll(samplePoints);
+    }
+
+    KPlotObject *q;
+
+    // Called whenever points were changed or removed
+    void changed();
+    // Called whenever the style of the object changes
+    void styleChanged();
+    // Called after points were added at the end, from index first on
+    void pointsAppended(qsizetype first);
+    // Tell the widgets showing the object about a change, see
+    // KPlotWidget::plotObjectChanged(), or keep it for endUpdate()
+    void notifyWidgets(qsizetype first);
+    void appendColumns(const KPlotPoint *p);
+    void rebuildColumns();
+    // Called by the points of pList when they are edited in place
+    void pointEdited();
+    // Rebuild the columns if points were edited since they were built
+    void syncColumns();
+    // Make p report its edits to owner, or to no object
+    static void setOwner(KPlotPoint *p, KPlotObject *owner);
+    // The number of points, which is also the size of yColumn
+    qsizetype count() const
+    {
+        return yColumn.size();
+    }
+    // The x-coordinate of point i, computed for uniformly sampled objects
+    double xAt(qsizetype i) const
+    {
+        return uniformX ? x0 + i * dx : xColumn[i];
+    }
+    // The same on a logarithmic axis if log is set, once scaledXColumn() was called
+    double scaledXAt(qsizetype i, bool log) const
+    {
+        if (uniformX) {
+            return log ? log10(x0 + i * dx) : x0 + i * dx;
+        }
+        return log ? logXColumn[i] : xColumn[i];
+    }
+    // Store the points of a uniformly sampled object explicitly
+    void makeExplicit();
+    // The KPlotPoint of point i; for uniformly sampled objects, only the
+    // points asked for are created, see samplePoints
+    KPlotPoint *pointAt(qsizetype i);
+    // Whether a point at x continues the uniform samples as the next one
+    bool isNextSample(double x) const;
+    // Append a sample to a uniformly sampled object
+    void appendSample(double y);
+    // Start the extents over for no points
+    void resetExtents();
+    // Returns in x1, x2, y1, y2 the extents of the finite points, or false
+    // if there are none
+    bool extents(double *x1, double *x2, double *y1, double *y2);
+    const QList<double> &scaledXColumn(bool log);
+    const QList<double> &scaledYColumn(bool log);
+    // Make mappedPoints valid for t in the index range [first, last)
+    void mapPoints(const KPlotTransform &t, qsizetype first, qsizetype last);
+    void mapRange(const KPlotTransform &t, qsizetype first, qsizetype last);
+    /*
+     * Returns in [first, last) the indices of the points whose x lies
+     * within [x1, x2], plus one neighbour on each side.  This is the whole
+     * list unless the points are sorted by x.
+     */
+    void visibleRange(double x1, double x2, qsizetype *first, qsizetype *last) const;
+    // What the object draws for a view, in screen coordinates
+    struct DisplayList {
+        bool valid = false;
+        // The view and the state of the object it was recorded for
+        KPlotTransform transform;
+        quint64 revision = 0;
+        QList<QRectF> bars;
+        // Polylines stored one after the other, lineRuns holds the
+        // number of points of each
+        QList<QPointF> linePoints;
+        QList<int> lineRuns;
+        QList<QPointF> markers;
+        // The letter drawn by each marker, for the Letter style
+        QStringList letters;
+        // The index into colorTable and the size of each marker, if the
+        // points have values and sizes; -1 for the pen and brush
+        QList<int> markerColors;
+        QList<double> markerSizes;
+        // Pixel squares drawn instead of the markers of dense points,
+        // with their colors like markerColors
+        QList<QRectF> dots;
+        QList<int> dotColors;
+        QList<QPointF> labelAnchors;
+        QStringList labels;
+    };
+
+    /*
+     * Draw the object for transform t, masking what was drawn in mask
+     * and placing the labels around it.  Only the points with x in
+     * [fromX, toX] (and their neighbours) are visited, so the painter
+     * should be clipped to that range.  Drawings of the whole plot are
+     * recorded into displayList and replayed while the object and the
+     * view stay the same.
+     */
+    void draw(QPainter *painter, KPlotMask *mask, const KPlotTransform &t, double fromX, double toX);
+    /*
+     * The drawing part of draw(), for points that were already mapped
+     * with mapPoints().  Without a mask, nothing is masked and no labels
+     * are placed, and the object is only read, so that several threads
+     * can paint parts of it at once.
+     */
+    void paint(QPainter *painter, KPlotMask *mask, const KPlotTransform &t, double fromX, double toX) const;
+    // Add to list what paint() draws, for points already mapped with mapPoints()
+    void record(DisplayList *list, const KPlotTransform &t, double fromX, double toX) const;
+    // Whether the markers of the points visible in t are dense enough to be drawn as dots
+    bool dense(const KPlotTransform &t) const;
+    // Returns in n the number of points inside the view of t, and in
+    // markerSize the largest marker size among them
+    void countInView(const KPlotTransform &t, qsizetype *n, double *markerSize) const;
+    // Keep the count of points in the view of t for dense(), so that the
+    // tiles and strips of the view share it
+    void updateViewCount(const KPlotTransform &t);
+    // Replace the markers of list by dots, one per occupied dot of pixRect
+    static void collapseMarkers(DisplayList *list, const QRect &pixRect, int dotSize);
+    // The index into colorTable for the value of point i, or -1 for none
+    int colorIndex(qsizetype i) const;
+    /*
+     * Sort the indices of n markers or dots with the given colors into
+     * order by color, with the first of color c at starts[c + 1] and the
+     * ones drawn with the pen at starts[0].  Without colors, order is left
+     * empty and all are in the first group.
+     */
+    void groupByColor(const QList<int> &colors, qsizetype n, QList<qsizetype> *order, QList<qsizetype> *starts) const;
+    // Draw list like paint() does, including the masking and the labels
+    void replay(QPainter *painter, KPlotMask *mask, const DisplayList &list) const;
+    // Draw the point marker of the given size centered at q
+    void drawMarker(QPainter *painter, const QPointF &q, double markerSize, const QString &letter) const;
+    // Distance around a point or line end, in pixels, that its drawing can cover
+    double reach() const;
+    /*
+     * Returns a copy of the state needed to draw the object, which can be
+     * drawn on another thread while this object changes.  The points
+     * themselves are only copied for bars and labels.
+     */
+    std::unique_ptr<Private> snapshot() const;
+    /*
+     * Returns a copy of the object reduced to about four points per pixel
+     * column of t, for a quick preview: the first, last, lowest and
+     * highest point of each column if the points are sorted by x, every
+     * n-th point otherwise.  Returns nullptr if the object has bars or
+     * labels, or is small enough to be drawn as it is.
+     */
+    std::unique_ptr<Private> decimated(const KPlotTransform &t) const;
+    // Copy the style and the point order to s
+    void copyStyle(Private *s) const;
+    // The points near the plot area of a view, bucketed into square cells
+    // of the screen for hit tests
+    struct PointGrid {
+        bool valid = false;
+        // The view and the state of the object it was built for
+        KPlotTransform transform;
+        quint64 revision = 0;
+        // The pixels covered, and the number of cells across and down
+        QRect area;
+        int columns = 0;
+        int rows = 0;
+        // The points of cell c are at [starts[c], starts[c + 1]) of
+        // indices and positions, in order of index
+        QList<qsizetype> starts;
+        QList<qsizetype> indices;
+        QList<QPoint> positions;
+    };
+    // Bring pointGrid up to date for t, covering radius pixels around the plot area
+    void updatePointGrid(const KPlotTransform &t, int radius);
+    /*
+     * Returns in order the indices of the points whose screen position is
+     * within the manhattan distance radius of p in t.  If nearest is set,
+     * it receives the index of the closest one, or -1.
+     */
+    QList<qsizetype> pointsNear(const KPlotTransform &t, const QPoint &p, int radius, qsizetype *nearest = nullptr);
+
+    QList<KPlotPoint *> pList;
+    // The points of a uniformly sampled object that were handed out, by
+    // index; they become part of pList when the object is made explicit
+    QHash<qsizetype, KPlotPoint *> samplePoints;
+    // Coordinates of the points in pList, stored as contiguous columns
+    // so that they can be mapped to the screen in one pass.
+    QList<double> xColumn, yColumn;
+    // Whether points were edited in place since the columns were built;
+    // the columns are rebuilt before they are next read
+    bool columnsDirty = false;
+    // Whether the points are samples at x0 + i * dx, of which only
+    // yColumn is stored; pList and xColumn are empty then
+    bool uniformX = false;
+    double x0 = 0.0;
+    double dx = 1.0;
+    // log10 of the coordinate columns, filled in on demand for logarithmic
+    // axes and kept while the points do not change
+    QList<double> logXColumn, logYColumn;
+    // Screen positions of the points for mappedTransform; only the
+    // entries in [mappedFirst, mappedLast) are up to date
+    QList<QPointF> mappedPoints;
+    KPlotTransform mappedTransform;
+    qsizetype mappedFirst = 0;
+    qsizetype mappedLast = 0;
+    bool mappedValid = false;
+    // The last drawing of the whole plot
+    DisplayList displayList;
+    PointGrid pointGrid;
+    // Whether xColumn is in non-decreasing order, which allows
+    // binary searching for the visible points
+    bool sortedX = true;
+    // The extents of the finite points, kept up to date as points are
+    // added; removing a point on their edge leaves them to be recomputed
+    double minX = qInf();
+    double maxX = -qInf();
+    double minY = qInf();
+    double maxY = -qInf();
+    bool extentsValid = true;
+    // Largest explicit bar width, to extend the range of visible bars
+    double maxBarWidth = 0.0;
+    // Labels and bar widths of the points in pList, which end at the last
+    // point that has one, so that drawing does not need the points
+    QList<QString> labelColumn;
+    QList<double> barWidthColumn;
+    // Stamp of the last change, for caches of the rendered object
+    quint64 revision = 0;
+    // Stamp of the last change other than appending points; a rendering
+    // made since then can be brought up to date by drawing the new points
+    quint64 resetRevision = 0;
+    // Number of points with a label, which are placed around other points
+    qsizetype labelCount = 0;
+    // The widgets showing this object, which are told about changes
+    QList<KPlotWidget *> widgets;
+    // Nesting of beginUpdate(), and the change the widgets are told about
+    // when the outermost update ends
+    int updateDepth = 0;
+    bool notifyPending = false;
+    qsizetype pendingFirst = 0;
+    // Samples pushed by another thread, see pushSample()
+    std::unique_ptr<KPlotSampleQueue> sampleQueue;
+    PlotTypes type;
+    PointStyle pointStyle;
+    double size;
+    double pointDensityLimit = 1.0;
+    // Optional columns of the points, which can be shorter than pList
+    QList<double> pointValues, pointSizes;
+    // Largest of pointSizes, for reach(); kept when points are removed
+    double maxPointSize = 0.0;
+    // The points inside a view, as counted by updateViewCount()
+    struct ViewCount {
+        bool valid = false;
+        quint64 revision = 0;
+        KPlotTransform transform;
+        qsizetype n = 0;
+        double markerSize = 0.0;
+    };
+    ViewCount viewCount;
+    QList<QColor> colorTable;
+    double minimumValue = 0.0;
+    double maximumValue = 1.0;
+    QPen pen, linePen, barPen, labelPen;
+    QBrush brush, barBrush;
+};
+
+#endif
@@ -6,27 +6,17 @@
 */
 
 #include "kplotpoint.h"
+#include "kplotobject_p.h"
+#include "kplotpoint_p.h"
 
-#include <QPointF>
 #include <QtAlgorithms>
 
-class KPlotPoint::Private
+void KPlotPoint::Private::changed()
 {
-public:
-    Private(KPlotPoint *qq, const QPointF &p, const QString &l, double bw)
-        : q(qq)
-        , point(p)
-        , label(l)
-        , barWidth(bw)
-    {
+    if (owner) {
+        owner->d->pointEdited();
     }
-
-    KPlotPoint *q;
-
-    QPointF point;
-    QString label;
-    double barWidth;
-};
+}
 
 KPlotPoint::KPlotPoint()
     : d(new Private(this, QPointF(), QString(), 0.0))
@@ -53,6 +43,7 @@ QPointF KPlotPoint::position() const
 void KPlotPoint::setPosition(const QPointF &pos)
 {
     d->point = pos;
+    d->changed();
 }
 
 double KPlotPoint::x() const
@@ -63,6 +54,7 @@ double KPlotPoint::x() const
 void KPlotPoint::setX(double x)
 {
     d->point.setX(x);
+    d->changed();
 }
 
 double KPlotPoint::y() const
@@ -73,6 +65,7 @@ double KPlotPoint::y() const
 void KPlotPoint::setY(double y)
 {
     d->point.setY(y);
+    d->changed();
 }
 
 QString KPlotPoint::label() const
@@ -83,6 +76,7 @@ QString KPlotPoint::label() const
 void KPlotPoint::setLabel(const QString &label)
 {
     d->label = label;
+    d->changed();
 }
 
 double KPlotPoint::barWidth() const
@@ -93,4 +87,5 @@ double KPlotPoint::barWidth() const
 void KPlotPoint::setBarWidth(double w)
 {
     d->barWidth = w;
+    d->changed();
 }
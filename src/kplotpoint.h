@@ -124,6 +124,8 @@ public:
     void setBarWidth(double w);
 
 private:
+    friend class KPlotObject;
+
     class Private;
     std::unique_ptr<Private> const d;
 
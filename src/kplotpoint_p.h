@@ -0,0 +1,41 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2003 Jason Harris <kstars@30doradus.org>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KPLOTPOINT_P_H
+#define KPLOTPOINT_P_H
+
+#include "kplotpoint.h"
+
+#include <QPointF>
+
+class KPlotObject;
+
+class KPlotPoint::Private
+{
+public:
+    Private(KPlotPoint *qq, const QPointF &p, const QString &l, double bw)
+        : q(qq)
+        , point(p)
+        , label(l)
+        , barWidth(bw)
+    {
+    }
+
+    // Tell the owner that the point was edited in place
+    void changed();
+
+    KPlotPoint *q;
+
+    QPointF point;
+    QString label;
+    double barWidth;
+    // The object whose points() hold this point, which keeps its own
+    // copy of the coordinates
+    KPlotObject *owner = nullptr;
+};
+
+#endif
@@ -0,0 +1,760 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2003 Jason Harris <kstars@30doradus.org>
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "kplotrenderer.h"
+#include "kplotrenderer_p.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include <QPainter>
+#include <QtAlgorithms>
+
+#include "kplotaxis.h"
+#include "kplotobject.h"
+#include "kplotobject_p.h"
+#include "kplotpoint.h"
+
+#define XPADDING 20
+#define YPADDING 20
+#define BIGTICKSIZE 10
+#define SMALLTICKSIZE 4
+#define TICKOFFSET 0
+
+KPlotRenderer::Private::Private(KPlotRenderer *qq)
+    : q(qq)
+    , cBackground(Qt::black)
+    , cForeground(Qt::white)
+    , cGrid(Qt::gray)
+    , showGrid(false)
+    , useAntialias(false)
+    , logX(false)
+    , logY(false)
+    , leftPadding(-1)
+    , rightPadding(-1)
+    , topPadding(-1)
+    , bottomPadding(-1)
+    , pickRadius(4)
+{
+    // create the axes and setting their default properties
+    KPlotAxis *leftAxis = new KPlotAxis();
+    leftAxis->setTickLabelsShown(true);
+    axes.insert(LeftAxis, leftAxis);
+    KPlotAxis *bottomAxis = new KPlotAxis();
+    bottomAxis->setTickLabelsShown(true);
+    axes.insert(BottomAxis, bottomAxis);
+    KPlotAxis *rightAxis = new KPlotAxis();
+    axes.insert(RightAxis, rightAxis);
+    KPlotAxis *topAxis = new KPlotAxis();
+    axes.insert(TopAxis, topAxis);
+}
+
+KPlotRenderer::Private::~Private()
+{
+    qDeleteAll(axes);
+}
+
+void KPlotRenderer::Private::calcDataRectLimits(double x1, double x2, double y1, double y2)
+{
+    double XA1;
+    double XA2;
+    double YA1;
+    double YA2;
+    if (x2 < x1) {
+        XA1 = x2;
+        XA2 = x1;
+    } else {
+        XA1 = x1;
+        XA2 = x2;
+    }
+    if (y2 < y1) {
+        YA1 = y2;
+        YA2 = y1;
+    } else {
+        YA1 = y1;
+        YA2 = y2;
+    }
+
+    if (XA2 == XA1) {
+        // qWarning() << "x1 and x2 cannot be equal. Setting x2 = x1 + 1.0";
+        XA2 = XA1 + 1.0;
+    }
+    if (YA2 == YA1) {
+        // qWarning() << "y1 and y2 cannot be equal. Setting y2 = y1 + 1.0";
+        YA2 = YA1 + 1.0;
+    }
+    dataRect = QRectF(XA1, YA1, XA2 - XA1, YA2 - YA1);
+    updateTransform();
+    updateTickMarks();
+}
+
+void KPlotRenderer::Private::updateTickMarks()
+{
+    if (deferTickMarks) {
+        tickMarksDirty = true;
+        return;
+    }
+    axes.value(LeftAxis)->setTickMarks(dataRect.y(), dataRect.height());
+    axes.value(BottomAxis)->setTickMarks(dataRect.x(), dataRect.width());
+    if (secondDataRect.isNull()) {
+        updateSecondaryTickMarks();
+    }
+}
+
+void KPlotRenderer::Private::updateSecondaryTickMarks()
+{
+    if (deferTickMarks) {
+        tickMarksDirty = true;
+        return;
+    }
+    const QRectF &r = secondDataRect.isNull() ? dataRect : secondDataRect;
+    axes.value(RightAxis)->setTickMarks(r.y(), r.height());
+    axes.value(TopAxis)->setTickMarks(r.x(), r.width());
+}
+
+void KPlotRenderer::Private::ensureTickMarks()
+{
+    if (!tickMarksDirty) {
+        return;
+    }
+    const bool deferred = deferTickMarks;
+    deferTickMarks = false;
+    tickMarksDirty = false;
+    updateTickMarks();
+    if (!secondDataRect.isNull()) {
+        updateSecondaryTickMarks();
+    }
+    deferTickMarks = deferred;
+}
+
+void KPlotRenderer::Private::updateTransform()
+{
+    transform = KPlotTransform(dataRect, pixRect, logX, logY);
+}
+
+void KPlotRenderer::Private::updatePixRect()
+{
+    const int newWidth = size.width() - q->leftPadding() - q->rightPadding();
+    const int newHeight = size.height() - q->topPadding() - q->bottomPadding();
+    // PixRect starts at (0,0) because we will translate by leftPadding(), topPadding()
+    const QRect r(0, 0, newWidth, newHeight);
+    if (r != pixRect) {
+        pixRect = r;
+        updateTransform();
+    }
+}
+
+KPlotRenderer::KPlotRenderer()
+    : d(new Private(this))
+{
+    // sets the default limits
+    d->calcDataRectLimits(0.0, 1.0, 0.0, 1.0);
+}
+
+KPlotRenderer::~KPlotRenderer() = default;
+
+QSize KPlotRenderer::size() const
+{
+    return d->size;
+}
+
+void KPlotRenderer::setSize(const QSize &size)
+{
+    d->size = size;
+    d->updatePixRect();
+}
+
+QRect KPlotRenderer::pixRect() const
+{
+    return d->pixRect;
+}
+
+void KPlotRenderer::setLimits(double x1, double x2, double y1, double y2)
+{
+    d->calcDataRectLimits(x1, x2, y1, y2);
+}
+
+void KPlotRenderer::setSecondaryLimits(double x1, double x2, double y1, double y2)
+{
+    double XA1;
+    double XA2;
+    double YA1;
+    double YA2;
+    if (x2 < x1) {
+        XA1 = x2;
+        XA2 = x1;
+    } else {
+        XA1 = x1;
+        XA2 = x2;
+    }
+    if (y2 < y1) {
+        YA1 = y2;
+        YA2 = y1;
+    } else {
+        YA1 = y1;
+        YA2 = y2;
+    }
+
+    if (XA2 == XA1) {
+        // qWarning() << "x1 and x2 cannot be equal. Setting x2 = x1 + 1.0";
+        XA2 = XA1 + 1.0;
+    }
+    if (YA2 == YA1) {
+        // qWarning() << "y1 and y2 cannot be equal. Setting y2 = y1 + 1.0";
+        YA2 = YA1 + 1.0;
+    }
+    d->secondDataRect = QRectF(XA1, YA1, XA2 - XA1, YA2 - YA1);
+    d->updateSecondaryTickMarks();
+}
+
+void KPlotRenderer::clearSecondaryLimits()
+{
+    d->secondDataRect = QRectF();
+    d->updateSecondaryTickMarks();
+}
+
+QRectF KPlotRenderer::dataRect() const
+{
+    return d->dataRect;
+}
+
+QRectF KPlotRenderer::secondaryDataRect() const
+{
+    return d->secondDataRect;
+}
+
+bool KPlotRenderer::isLogScale(Qt::Orientation orientation) const
+{
+    return orientation == Qt::Horizontal ? d->logX : d->logY;
+}
+
+void KPlotRenderer::setLogScale(Qt::Orientation orientation, bool log)
+{
+    if (orientation == Qt::Horizontal) {
+        d->logX = log;
+        axis(BottomAxis)->setLogScale(log);
+        axis(TopAxis)->setLogScale(log);
+    } else {
+        d->logY = log;
+        axis(LeftAxis)->setLogScale(log);
+        axis(RightAxis)->setLogScale(log);
+    }
+
+    // recompute the tickmarks for the new scale
+    d->calcDataRectLimits(d->dataRect.left(), d->dataRect.right(), d->dataRect.top(), d->dataRect.bottom());
+    if (!d->secondDataRect.isNull()) {
+        d->updateSecondaryTickMarks();
+    }
+}
+
+void KPlotRenderer::addPlotObject(KPlotObject *object)
+{
+    // skip null pointers
+    if (object) {
+        d->objectList.append(object);
+    }
+}
+
+void KPlotRenderer::addPlotObjects(const QList<KPlotObject *> &objects)
+{
+    for (KPlotObject *o : objects) {
+        addPlotObject(o);
+    }
+}
+
+QList<KPlotObject *> KPlotRenderer::plotObjects() const
+{
+    return d->objectList;
+}
+
+void KPlotRenderer::replacePlotObject(int i, KPlotObject *o)
+{
+    // skip null pointers and invalid indexes
+    if (!o || i < 0 || i >= d->objectList.count()) {
+        return;
+    }
+    d->objectList.replace(i, o);
+}
+
+void KPlotRenderer::removeAllPlotObjects()
+{
+    d->objectList.clear();
+}
+
+QColor KPlotRenderer::backgroundColor() const
+{
+    return d->cBackground;
+}
+
+QColor KPlotRenderer::foregroundColor() const
+{
+    return d->cForeground;
+}
+
+QColor KPlotRenderer::gridColor() const
+{
+    return d->cGrid;
+}
+
+void KPlotRenderer::setBackgroundColor(const QColor &bg)
+{
+    d->cBackground = bg;
+}
+
+void KPlotRenderer::setForegroundColor(const QColor &fg)
+{
+    d->cForeground = fg;
+}
+
+void KPlotRenderer::setGridColor(const QColor &gc)
+{
+    d->cGrid = gc;
+}
+
+bool KPlotRenderer::isGridShown() const
+{
+    return d->showGrid;
+}
+
+void KPlotRenderer::setShowGrid(bool show)
+{
+    d->showGrid = show;
+}
+
+bool KPlotRenderer::antialiasing() const
+{
+    return d->useAntialias;
+}
+
+void KPlotRenderer::setAntialiasing(bool b)
+{
+    d->useAntialias = b;
+}
+
+QFont KPlotRenderer::font() const
+{
+    return d->font;
+}
+
+void KPlotRenderer::setFont(const QFont &font)
+{
+    d->font = font;
+}
+
+KPlotAxis *KPlotRenderer::axis(Axis type)
+{
+    QHash<Axis, KPlotAxis *>::Iterator it = d->axes.find(type);
+    return it != d->axes.end() ? it.value() : nullptr;
+}
+
+const KPlotAxis *KPlotRenderer::axis(Axis type) const
+{
+    QHash<Axis, KPlotAxis *>::ConstIterator it = d->axes.constFind(type);
+    return it != d->axes.constEnd() ? it.value() : nullptr;
+}
+
+QPointF KPlotRenderer::mapToPixRect(const QPointF &p) const
+{
+    return d->transform.map(p);
+}
+
+QList<KPlotPoint *> KPlotRenderer::pointsUnderPoint(const QPoint &p) const
+{
+    QList<KPlotPoint *> pts;
+    for (const KPlotObject *po : std::as_const(d->objectList)) {
+        KPlotObject::Private *od = po->d.get();
+        const QList<qsizetype> indices = od->pointsNear(d->transform, p, d->pickRadius);
+        for (qsizetype i : indices) {
+            pts << od->pointAt(i);
+        }
+    }
+
+    return pts;
+}
+
+KPlotPoint *KPlotRenderer::nearestPoint(const QPoint &p) const
+{
+    KPlotPoint *nearest = nullptr;
+    int nearestDistance = d->pickRadius + 1;
+    for (const KPlotObject *po : std::as_const(d->objectList)) {
+        KPlotObject::Private *od = po->d.get();
+        qsizetype i;
+        od->pointsNear(d->transform, p, d->pickRadius, &i);
+        if (i < 0) {
+            continue;
+        }
+        // Earlier objects win ties, like in pointsUnderPoint()
+        const int distance = (p - d->transform.map(QPointF(od->xAt(i), od->yColumn[i])).toPoint()).manhattanLength();
+        if (distance < nearestDistance) {
+            nearestDistance = distance;
+            nearest = od->pointAt(i);
+        }
+    }
+
+    return nearest;
+}
+
+int KPlotRenderer::pickRadius() const
+{
+    return d->pickRadius;
+}
+
+void KPlotRenderer::setPickRadius(int radius)
+{
+    d->pickRadius = qMax(radius, 0);
+}
+
+void KPlotRenderer::resetPlotMask()
+{
+    d->mask.reset(d->pixRect.size());
+}
+
+void KPlotRenderer::maskRect(const QRectF &rf, float fvalue)
+{
+    d->mask.maskRect(rf, fvalue);
+}
+
+void KPlotRenderer::maskAlongLine(const QPointF &p1, const QPointF &p2, float fvalue)
+{
+    d->mask.maskAlongLine(p1, p2, fvalue);
+}
+
+void KPlotRenderer::placeLabel(QPainter *painter, KPlotPoint *pp)
+{
+    d->mask.placeLabel(painter, mapToPixRect(pp->position()), pp->label());
+}
+
+void KPlotRenderer::render(QPainter *painter)
+{
+    // The paddings can depend on the axes, which may have changed
+    d->updatePixRect();
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, d->useAntialias);
+    painter->setFont(d->font);
+    painter->fillRect(QRect(QPoint(0, 0), d->size), d->cBackground);
+    painter->translate(leftPadding() + 0.5, topPadding() + 0.5);
+
+    drawPlotObjects(painter);
+    drawAxes(painter);
+
+    painter->restore();
+}
+
+void KPlotRenderer::drawPlotObjects(QPainter *painter)
+{
+    painter->save();
+    painter->setClipRect(d->pixRect, Qt::IntersectClip);
+
+    resetPlotMask();
+
+    for (KPlotObject *po : std::as_const(d->objectList)) {
+        po->draw(painter, this);
+    }
+
+    painter->restore();
+}
+
+QImage KPlotRenderer::toImage(qreal devicePixelRatio)
+{
+    QImage image(d->size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    QPainter p(&image);
+    render(&p);
+    return image;
+}
+
+void KPlotRenderer::drawAxes(QPainter *p)
+{
+    d->ensureTickMarks();
+    const KPlotTransform &t = d->transform;
+
+    if (d->showGrid) {
+        p->setPen(gridColor());
+
+        // Grid lines are placed at locations of primary axes' major tickmarks
+        // vertical grid lines
+        const QList<double> majMarks = axis(BottomAxis)->majorTickMarks();
+        for (const double xx : majMarks) {
+            double px = t.mapX(xx);
+            p->drawLine(QPointF(px, 0.0), QPointF(px, double(d->pixRect.height())));
+        }
+        // horizontal grid lines
+        const QList<double> leftTickMarks = axis(LeftAxis)->majorTickMarks();
+        for (const double yy : leftTickMarks) {
+            double py = t.mapY(yy);
+            p->drawLine(QPointF(0.0, py), QPointF(double(d->pixRect.width()), py));
+        }
+    }
+
+    p->setPen(foregroundColor());
+    p->setBrush(Qt::NoBrush);
+
+    // set small font for tick labels
+    QFont f = p->font();
+    int s = f.pointSize();
+    f.setPointSize(s - 2);
+    p->setFont(f);
+
+    /* BottomAxis */
+    KPlotAxis *a = axis(BottomAxis);
+    if (a->isVisible()) {
+        // Draw axis line
+        p->drawLine(0, d->pixRect.height(), d->pixRect.width(), d->pixRect.height());
+
+        // Draw major tickmarks
+        const QList<double> majMarks = a->majorTickMarks();
+        for (const double xx : majMarks) {
+            double px = t.mapX(xx);
+            if (px > 0 && px < d->pixRect.width()) {
+                p->drawLine(QPointF(px, double(d->pixRect.height() - TICKOFFSET)), //
+                            QPointF(px, double(d->pixRect.height() - BIGTICKSIZE - TICKOFFSET)));
+
+                // Draw ticklabel
+                if (a->areTickLabelsShown()) {
+                    QRect r(int(px) - BIGTICKSIZE, d->pixRect.height() + BIGTICKSIZE, 2 * BIGTICKSIZE, BIGTICKSIZE);
+                    p->drawText(r, Qt::AlignCenter | Qt::TextDontClip, a->tickLabel(xx));
+                }
+            }
+        }
+
+        // Draw minor tickmarks
+        const QList<double> minTickMarks = a->minorTickMarks();
+        for (const double xx : minTickMarks) {
+            double px = t.mapX(xx);
+            if (px > 0 && px < d->pixRect.width()) {
+                p->drawLine(QPointF(px, double(d->pixRect.height() - TICKOFFSET)), //
+                            QPointF(px, double(d->pixRect.height() - SMALLTICKSIZE - TICKOFFSET)));
+            }
+        }
+
+        // Draw BottomAxis Label
+        if (!a->label().isEmpty()) {
+            QRect r(0, d->pixRect.height() + 2 * YPADDING, d->pixRect.width(), YPADDING);
+            p->drawText(r, Qt::AlignCenter, a->label());
+        }
+    } // End of BottomAxis
+
+    /* LeftAxis */
+    a = axis(LeftAxis);
+    if (a->isVisible()) {
+        // Draw axis line
+        p->drawLine(0, 0, 0, d->pixRect.height());
+
+        // Draw major tickmarks
+        const QList<double> majMarks = a->majorTickMarks();
+        for (const double yy : majMarks) {
+            double py = t.mapY(yy);
+            if (py > 0 && py < d->pixRect.height()) {
+                p->drawLine(QPointF(TICKOFFSET, py), QPointF(double(TICKOFFSET + BIGTICKSIZE), py));
+
+                // Draw ticklabel
+                if (a->areTickLabelsShown()) {
+                    QRect r(-2 * BIGTICKSIZE - SMALLTICKSIZE, int(py) - SMALLTICKSIZE, 2 * BIGTICKSIZE, 2 * SMALLTICKSIZE);
+                    p->drawText(r, Qt::AlignRight | Qt::AlignVCenter | Qt::TextDontClip, a->tickLabel(yy));
+                }
+            }
+        }
+
+        // Draw minor tickmarks
+        const QList<double> minTickMarks = a->minorTickMarks();
+        for (const double yy : minTickMarks) {
+            double py = t.mapY(yy);
+            if (py > 0 && py < d->pixRect.height()) {
+                p->drawLine(QPointF(TICKOFFSET, py), QPointF(double(TICKOFFSET + SMALLTICKSIZE), py));
+            }
+        }
+
+        // Draw LeftAxis Label.  We need to draw the text sideways.
+        if (!a->label().isEmpty()) {
+            // store current painter translation/rotation state
+            p->save();
+
+            // translate coord sys to left corner of axis label rectangle, then rotate 90 degrees.
+            p->translate(-3 * XPADDING, d->pixRect.height());
+            p->rotate(-90.0);
+
+            QRect r(0, 0, d->pixRect.height(), XPADDING);
+            p->drawText(r, Qt::AlignCenter, a->label()); // draw the label, now that we are sideways
+
+            p->restore(); // restore translation/rotation state
+        }
+    } // End of LeftAxis
+
+    // Prepare for top and right axes; we may need the secondary data rect
+    KPlotTransform t2 = t;
+    if (secondaryDataRect().isValid()) {
+        t2 = KPlotTransform(secondaryDataRect(), d->pixRect, d->logX, d->logY);
+    }
+
+    /* TopAxis */
+    a = axis(TopAxis);
+    if (a->isVisible()) {
+        // Draw axis line
+        p->drawLine(0, 0, d->pixRect.width(), 0);
+
+        // Draw major tickmarks
+        const QList<double> majMarks = a->majorTickMarks();
+        for (const double xx : majMarks) {
+            double px = t2.mapX(xx);
+            if (px > 0 && px < d->pixRect.width()) {
+                p->drawLine(QPointF(px, TICKOFFSET), QPointF(px, double(BIGTICKSIZE + TICKOFFSET)));
+
+                // Draw ticklabel
+                if (a->areTickLabelsShown()) {
+                    QRect r(int(px) - BIGTICKSIZE, (int)-1.5 * BIGTICKSIZE, 2 * BIGTICKSIZE, BIGTICKSIZE);
+                    p->drawText(r, Qt::AlignCenter | Qt::TextDontClip, a->tickLabel(xx));
+                }
+            }
+        }
+
+        // Draw minor tickmarks
+        const QList<double> minMarks = a->minorTickMarks();
+        for (const double xx : minMarks) {
+            double px = t2.mapX(xx);
+            if (px > 0 && px < d->pixRect.width()) {
+                p->drawLine(QPointF(px, TICKOFFSET), QPointF(px, double(SMALLTICKSIZE + TICKOFFSET)));
+            }
+        }
+
+        // Draw TopAxis Label
+        if (!a->label().isEmpty()) {
+            QRect r(0, 0 - 3 * YPADDING, d->pixRect.width(), YPADDING);
+            p->drawText(r, Qt::AlignCenter, a->label());
+        }
+    } // End of TopAxis
+
+    /* RightAxis */
+    a = axis(RightAxis);
+    if (a->isVisible()) {
+        // Draw axis line
+        p->drawLine(d->pixRect.width(), 0, d->pixRect.width(), d->pixRect.height());
+
+        // Draw major tickmarks
+        const QList<double> majMarks = a->majorTickMarks();
+        for (const double yy : majMarks) {
+            double py = t2.mapY(yy);
+            if (py > 0 && py < d->pixRect.height()) {
+                p->drawLine(QPointF(double(d->pixRect.width() - TICKOFFSET), py), //
+                            QPointF(double(d->pixRect.width() - TICKOFFSET - BIGTICKSIZE), py));
+
+                // Draw ticklabel
+                if (a->areTickLabelsShown()) {
+                    QRect r(d->pixRect.width() + SMALLTICKSIZE, int(py) - SMALLTICKSIZE, 2 * BIGTICKSIZE, 2 * SMALLTICKSIZE);
+                    p->drawText(r, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextDontClip, a->tickLabel(yy));
+                }
+            }
+        }
+
+        // Draw minor tickmarks
+        const QList<double> minMarks = a->minorTickMarks();
+        for (const double yy : minMarks) {
+            double py = t2.mapY(yy);
+            if (py > 0 && py < d->pixRect.height()) {
+                p->drawLine(QPointF(double(d->pixRect.width() - 0.0), py), QPointF(double(d->pixRect.width() - 0.0 - SMALLTICKSIZE), py));
+            }
+        }
+
+        // Draw RightAxis Label.  We need to draw the text sideways.
+        if (!a->label().isEmpty()) {
+            // store current painter translation/rotation state
+            p->save();
+
+            // translate coord sys to left corner of axis label rectangle, then rotate 90 degrees.
+            p->translate(d->pixRect.width() + 2 * XPADDING, d->pixRect.height());
+            p->rotate(-90.0);
+
+            QRect r(0, 0, d->pixRect.height(), XPADDING);
+            p->drawText(r, Qt::AlignCenter, a->label()); // draw the label, now that we are sideways
+
+            p->restore(); // restore translation/rotation state
+        }
+    } // End of RightAxis
+}
+
+int KPlotRenderer::leftPadding() const
+{
+    if (d->leftPadding >= 0) {
+        return d->leftPadding;
+    }
+    const KPlotAxis *a = axis(LeftAxis);
+    if (a && a->isVisible() && a->areTickLabelsShown()) {
+        return !a->label().isEmpty() ? 3 * XPADDING : 2 * XPADDING;
+    }
+    return XPADDING;
+}
+
+int KPlotRenderer::rightPadding() const
+{
+    if (d->rightPadding >= 0) {
+        return d->rightPadding;
+    }
+    const KPlotAxis *a = axis(RightAxis);
+    if (a && a->isVisible() && a->areTickLabelsShown()) {
+        return !a->label().isEmpty() ? 3 * XPADDING : 2 * XPADDING;
+    }
+    return XPADDING;
+}
+
+int KPlotRenderer::topPadding() const
+{
+    if (d->topPadding >= 0) {
+        return d->topPadding;
+    }
+    const KPlotAxis *a = axis(TopAxis);
+    if (a && a->isVisible() && a->areTickLabelsShown()) {
+        return !a->label().isEmpty() ? 3 * YPADDING : 2 * YPADDING;
+    }
+    return YPADDING;
+}
+
+int KPlotRenderer::bottomPadding() const
+{
+    if (d->bottomPadding >= 0) {
+        return d->bottomPadding;
+    }
+    const KPlotAxis *a = axis(BottomAxis);
+    if (a && a->isVisible() && a->areTickLabelsShown()) {
+        return !a->label().isEmpty() ? 3 * YPADDING : 2 * YPADDING;
+    }
+    return YPADDING;
+}
+
+void KPlotRenderer::setLeftPadding(int padding)
+{
+    d->leftPadding = padding;
+    d->updatePixRect();
+}
+
+void KPlotRenderer::setRightPadding(int padding)
+{
+    d->rightPadding = padding;
+    d->updatePixRect();
+}
+
+void KPlotRenderer::setTopPadding(int padding)
+{
+    d->topPadding = padding;
+    d->updatePixRect();
+}
+
+void KPlotRenderer::setBottomPadding(int padding)
+{
+    d->bottomPadding = padding;
+    d->updatePixRect();
+}
+
+void KPlotRenderer::setDefaultPaddings()
+{
+    d->leftPadding = -1;
+    d->rightPadding = -1;
+    d->topPadding = -1;
+    d->bottomPadding = -1;
+    d->updatePixRect();
+}
@@ -0,0 +1,487 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KPLOTRENDERER_H
+#define KPLOTRENDERER_H
+
+#include <kplotting_export.h>
+
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QList>
+#include <QRect>
+
+#include <memory>
+
+class QPainter;
+class KPlotAxis;
+class KPlotObject;
+class KPlotPoint;
+
+/*!
+ * \class KPlotRenderer
+ * \inmodule KPlotting
+ *
+ * \brief Draws plots on any QPaintDevice, without a widget.
+ *
+ * KPlotRenderer holds the description of a plot, i.e. the data limits,
+ * the axes, the colors and the list of KPlotObjects, and draws it with a
+ * QPainter at a given size.  This is the drawing code that KPlotWidget
+ * uses, so plots look the same in a widget and in an image, a PDF file
+ * or an SVG document.
+ *
+ * KPlotRenderer does not need a QApplication with a windowing system, so
+ * it can be used with the offscreen platform, and from worker threads.
+ *
+ * Example of usage:
+ *
+ * \code
+ * KPlotRenderer renderer;
+ * renderer.setSize(QSize(640, 480));
+ * renderer.setLimits(1.0, 5.0, 1.0, 25.0);
+ *
+ * KPlotObject kpo(Qt::red, KPlotObject::Lines);
+ * for (float x = 1.0; x <= 5.0; x += 0.1)
+ *     kpo.addPoint(x, x * x);
+ * renderer.addPlotObject(&kpo);
+ *
+ * renderer.toImage().save("plot.png");
+ * \endcode
+ *
+ * \note KPlotRenderer does not take ownership of the objects added to it.
+ * A KPlotObject can be drawn by several renderers and widgets, but only
+ * by one at a time, and it must not be changed while it is drawn.  To
+ * render on a worker thread, hand the objects over to that thread until
+ * the rendering is done.
+ *
+ * \sa KPlotWidget
+ * \since 6.28
+ */
+class KPLOTTING_EXPORT KPlotRenderer
+{
+public:
+    /*!
+     * The four types of plot axes, as in KPlotWidget::Axis.
+     *
+     * \value LeftAxis the left axis
+     * \value BottomAxis the bottom axis
+     * \value RightAxis the right axis
+     * \value TopAxis the top axis
+     */
+    enum Axis {
+        LeftAxis = 0,
+        BottomAxis,
+        RightAxis,
+        TopAxis,
+    };
+
+    /*!
+     * Constructor.
+     *
+     * The plot has a size of 0x0 pixels until setSize() is called.
+     */
+    KPlotRenderer();
+
+    ~KPlotRenderer();
+
+    /*!
+     * Returns the size of the plot, including the paddings, in pixels
+     */
+    QSize size() const;
+
+    /*!
+     * Set the size of the plot, including the paddings, in pixels
+     *
+     * \a size the new size
+     */
+    void setSize(const QSize &size);
+
+    /*!
+     * Returns the rectangle of the plot area, in pixels.
+     *
+     * The plot area starts at (0,0); render() places it at an offset of
+     * leftPadding() and topPadding().  It is updated by setSize(), the
+     * padding setters and render().
+     */
+    QRect pixRect() const;
+
+    /*!
+     * Set new data limits for the plot.
+     *
+     * \a x1 the minimum X value in data units
+     *
+     * \a x2 the maximum X value in data units
+     *
+     * \a y1 the minimum Y value in data units
+     *
+     * \a y2 the maximum Y value in data units
+     *
+     * \sa KPlotWidget::setLimits()
+     */
+    void setLimits(double x1, double x2, double y1, double y2);
+
+    /*!
+     * Set the secondary data limits, which control the values displayed
+     * along the top and right axes.
+     *
+     * \a x1 the minimum X value in secondary data units
+     *
+     * \a x2 the maximum X value in secondary data units
+     *
+     * \a y1 the minimum Y value in secondary data units
+     *
+     * \a y2 the maximum Y value in secondary data units
+     *
+     * \sa KPlotWidget::setSecondaryLimits()
+     */
+    void setSecondaryLimits(double x1, double x2, double y1, double y2);
+
+    /*!
+     * Unset the secondary limits, so the top and right axes
+     * show the same tickmarks as the bottom and left axes
+     */
+    void clearSecondaryLimits();
+
+    /*!
+     * Returns the rectangle representing the boundaries of the plot,
+     * in natural data units.
+     */
+    QRectF dataRect() const;
+
+    /*!
+     * Returns the rectangle representing the boundaries of the secondary
+     * data limits, or a null rectangle if they have not been set.
+     */
+    QRectF secondaryDataRect() const;
+
+    /*!
+     * Returns whether the axes of the given \a orientation use a
+     * logarithmic scale.
+     */
+    bool isLogScale(Qt::Orientation orientation) const;
+
+    /*!
+     * Toggle logarithmic (base 10) scaling for the axes of the given
+     * \a orientation.
+     *
+     * \sa KPlotWidget::setLogScale()
+     */
+    void setLogScale(Qt::Orientation orientation, bool log);
+
+    /*!
+     * Add an item to the list of KPlotObjects to be plotted.
+     *
+     * \a object the KPlotObject to be added
+     */
+    void addPlotObject(KPlotObject *object);
+
+    /*!
+     * Add more than one KPlotObject at one time.
+     *
+     * \a objects the list of KPlotObjects to be added
+     */
+    void addPlotObjects(const QList<KPlotObject *> &objects);
+
+    /*!
+     * Returns the current list of plot objects
+     */
+    QList<KPlotObject *> plotObjects() const;
+
+    /*!
+     * Replace an item in the KPlotObject list.
+     *
+     * \a i the index of the item to be replaced
+     *
+     * \a o pointer to the replacement KPlotObject
+     */
+    void replacePlotObject(int i, KPlotObject *o);
+
+    /*!
+     * Removes all plot objects.  The objects are not deleted.
+     */
+    void removeAllPlotObjects();
+
+    /*!
+     * Returns the background color of the plot.
+     *
+     * The default color is black.
+     */
+    QColor backgroundColor() const;
+
+    /*!
+     * Returns the foreground color, used for axes, tickmarks and associated
+     * labels.
+     *
+     * The default color is white.
+     */
+    QColor foregroundColor() const;
+
+    /*!
+     * Returns the grid color.
+     *
+     * The default color is gray.
+     */
+    QColor gridColor() const;
+
+    /*!
+     * Set the background color
+     *
+     * \a bg the new background color
+     */
+    void setBackgroundColor(const QColor &bg);
+
+    /*!
+     * Set the foreground color
+     *
+     * \a fg the new foreground color
+     */
+    void setForegroundColor(const QColor &fg);
+
+    /*!
+     * Set the grid color
+     *
+     * \a gc the new grid color
+     */
+    void setGridColor(const QColor &gc);
+
+    /*!
+     * Returns whether the grid lines are shown
+     *
+     * Grid lines are not shown by default.
+     */
+    bool isGridShown() const;
+
+    /*!
+     * Toggle whether grid lines are drawn at major tickmarks.
+     *
+     * \a show if true, grid lines will be drawn.
+     */
+    void setShowGrid(bool show);
+
+    /*!
+     * Returns whether the antialiasing is active
+     *
+     * Antialiasing is not active by default.
+     */
+    bool antialiasing() const;
+
+    /*!
+     * Toggle antialiased drawing.
+     *
+     * \a b if true, the plot graphics will be antialiased.
+     */
+    void setAntialiasing(bool b);
+
+    /*!
+     * Returns the font that render() uses for labels
+     *
+     * The default is a default constructed QFont.
+     */
+    QFont font() const;
+
+    /*!
+     * Set the font that render() uses for labels
+     *
+     * \a font the new font
+     */
+    void setFont(const QFont &font);
+
+    /*!
+     * Returns the axis of the specified \a type, or 0 if no axis has been set.
+     */
+    KPlotAxis *axis(Axis type);
+
+    /*!
+     * Returns the axis of the specified \a type, or 0 if no axis has been set.
+     */
+    const KPlotAxis *axis(Axis type) const;
+
+    /*!
+     * Returns the number of pixels to the left of the plot area.
+     *
+     * Padding values are set to -1 by default; if unchanged, this
+     * function will try to guess a good value, based on whether
+     * ticklabels and/or axis labels need to be drawn.
+     */
+    int leftPadding() const;
+
+    /*!
+     * Returns the number of pixels to the right of the plot area.
+     *
+     * \sa leftPadding()
+     */
+    int rightPadding() const;
+
+    /*!
+     * Returns the number of pixels above the plot area.
+     *
+     * \sa leftPadding()
+     */
+    int topPadding() const;
+
+    /*!
+     * Returns the number of pixels below the plot area.
+     *
+     * \sa leftPadding()
+     */
+    int bottomPadding() const;
+
+    /*!
+     * Set the number of pixels to the left of the plot area.
+     *
+     * Set this to -1 to revert to automatic determination of padding values.
+     */
+    void setLeftPadding(int padding);
+
+    /*!
+     * Set the number of pixels to the right of the plot area.
+     *
+     * Set this to -1 to revert to automatic determination of padding values.
+     */
+    void setRightPadding(int padding);
+
+    /*!
+     * Set the number of pixels above the plot area.
+     *
+     * Set this to -1 to revert to automatic determination of padding values.
+     */
+    void setTopPadding(int padding);
+
+    /*!
+     * Set the number of pixels below the plot area.
+     *
+     * Set this to -1 to revert to automatic determination of padding values.
+     */
+    void setBottomPadding(int padding);
+
+    /*!
+     * Revert all four padding values to -1, so that they will be
+     * automatically determined.
+     */
+    void setDefaultPaddings();
+
+    /*!
+     * Map a coordinate \a p from the data rect to the pixel rect.
+     *
+     * Returns the coordinate in the pixel coordinate system of the plot area
+     */
+    QPointF mapToPixRect(const QPointF &p) const;
+
+    /*!
+     * Returns a list of points in the plot which are within pickRadius()
+     * pixels of the position \a p in the plot area.
+     *
+     * Points further than that outside of the plot area are never found.
+     * The points are found through a grid of their screen positions,
+     * which each object builds on the first query for a view and keeps
+     * while the view and the object stay the same.
+     */
+    QList<KPlotPoint *> pointsUnderPoint(const QPoint &p) const;
+
+    /*!
+     * Returns the point in the plot nearest to the position \a p in the
+     * plot area, or nullptr if none is within pickRadius() pixels.
+     *
+     * \since 6.28
+     */
+    KPlotPoint *nearestPoint(const QPoint &p) const;
+
+    /*!
+     * Returns the distance in pixels within which points are found by
+     * pointsUnderPoint() and nearestPoint().
+     *
+     * Distances are measured as the sum of the horizontal and vertical
+     * distances.  The default radius is 4.
+     *
+     * \since 6.28
+     */
+    int pickRadius() const;
+
+    /*!
+     * Set the distance in pixels within which points are found by
+     * pointsUnderPoint() and nearestPoint().
+     *
+     * \a radius the new pick radius
+     *
+     * \since 6.28
+     */
+    void setPickRadius(int radius);
+
+    /*!
+     * Reset the mask used for non-overlapping labels so that all
+     * regions of the plot area are considered empty.
+     */
+    void resetPlotMask();
+
+    /*!
+     * Indicate that object labels should try to avoid the given
+     * rectangle \a r of the plot area, with a weight of \a value.
+     *
+     * \sa KPlotWidget::maskRect()
+     */
+    void maskRect(const QRectF &r, float value = 1.0f);
+
+    /*!
+     * Indicate that object labels should try to avoid the line
+     * joining \a p1 and \a p2 in the plot area, with a weight of \a value.
+     *
+     * \sa KPlotWidget::maskAlongLine()
+     */
+    void maskAlongLine(const QPointF &p1, const QPointF &p2, float value = 1.0f);
+
+    /*!
+     * Draw the label of \a pp with \a painter, close to the point while
+     * avoiding the masked regions of the plot.
+     *
+     * \sa KPlotWidget::placeLabel()
+     */
+    void placeLabel(QPainter *painter, KPlotPoint *pp);
+
+    /*!
+     * Draw the whole plot with \a painter: the background, the plot
+     * objects, the grid and the axes, in the rectangle of size() at the
+     * origin of the painter.
+     *
+     * The painter state is left unchanged.
+     */
+    void render(QPainter *painter);
+
+    /*!
+     * Draw the plot objects with \a painter, clipped to the plot area.
+     *
+     * The painter is expected to be translated to the top left corner of
+     * the plot area, as done by render().  The label mask is reset first.
+     */
+    void drawPlotObjects(QPainter *painter);
+
+    /*!
+     * Draw the grid, the axes and their labels with \a painter.
+     *
+     * The painter is expected to be translated to the top left corner of
+     * the plot area, as done by render().  The tick labels are drawn with
+     * the font of the painter, 2 points smaller.
+     */
+    void drawAxes(QPainter *painter);
+
+    /*!
+     * Returns the plot rendered into an image of size(), for a device
+     * pixel ratio of \a devicePixelRatio.
+     */
+    QImage toImage(qreal devicePixelRatio = 1.0);
+
+private:
+    friend class KPlotObject;
+    friend class KPlotWidget;
+
+    class Private;
+    std::unique_ptr<Private> const d;
+
+    Q_DISABLE_COPY(KPlotRenderer)
+};
+
+#endif
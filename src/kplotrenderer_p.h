@@ -0,0 +1,69 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KPLOTRENDERER_P_H
+#define KPLOTRENDERER_P_H
+
+#include "kplotrenderer.h"
+
+#include <QHash>
+
+#include "kplotmask_p.h"
+#include "kplottransform_p.h"
+
+class Q_DECL_HIDDEN KPlotRenderer::Private
+{
+public:
+    Private(KPlotRenderer *qq);
+    ~Private();
+
+    KPlotRenderer *q;
+
+    void calcDataRectLimits(double x1, double x2, double y1, double y2);
+    // Set the tickmarks of the axes for the data rects, or only mark them
+    // out of date while deferTickMarks is set
+    void updateTickMarks();
+    // Set the tickmarks of the top and right axes for the secondary data rect
+    void updateSecondaryTickMarks();
+    // Bring tickmarks that were deferred up to date
+    void ensureTickMarks();
+    void updateTransform();
+    // Fit pixRect to the size and the paddings
+    void updatePixRect();
+
+    // Colors
+    QColor cBackground, cForeground, cGrid;
+    // draw options
+    bool showGrid;
+    bool useAntialias;
+    bool logX, logY;
+    QFont font;
+    // padding
+    int leftPadding, rightPadding, topPadding, bottomPadding;
+    // Manhattan distance in pixels within which points are hit
+    int pickRadius;
+    // Whether tickmarks are only computed when they are needed, during a
+    // batch of changes, and whether some are out of date
+    bool deferTickMarks = false;
+    bool tickMarksDirty = false;
+    // hashmap with the axes we have
+    QHash<Axis, KPlotAxis *> axes;
+    // List of KPlotObjects, not owned
+    QList<KPlotObject *> objectList;
+    // Limits of the plot area in data units
+    QRectF dataRect, secondDataRect;
+    // Size of the whole plot, including the paddings
+    QSize size;
+    // Limits of the plot area in pixel units
+    QRect pixRect;
+    // Mapping from dataRect to pixRect
+    KPlotTransform transform;
+    // The regions of the plot that labels should avoid
+    KPlotMask mask;
+};
+
+#endif
@@ -0,0 +1,89 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KPLOTSAMPLEQUEUE_P_H
+#define KPLOTSAMPLEQUEUE_P_H
+
+#include <QPointF>
+
+#include <atomic>
+#include <vector>
+
+/*
+ * A bounded queue of samples, written by one thread and read by another
+ * without locks.  The capacity is a power of two, so that the positions
+ * can run freely and be masked into the ring.
+ *
+ * The two positions sit on their own cache lines, so that the producer
+ * and the consumer do not invalidate each other's line on every sample.
+ */
+class KPlotSampleQueue
+{
+public:
+    explicit KPlotSampleQueue(qsizetype capacity)
+    {
+        qsizetype size = 1;
+        while (size < capacity) {
+            size *= 2;
+        }
+        m_ring.resize(size);
+        m_mask = size - 1;
+    }
+
+    qsizetype capacity() const
+    {
+        return m_mask + 1;
+    }
+
+    // Append a sample, from the producer thread.  Returns false if the
+    // queue is full.
+    bool push(double x, double y)
+    {
+        const quint64 head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail > quint64(m_mask)) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail > quint64(m_mask)) {
+                return false;
+            }
+        }
+        m_ring[head & m_mask] = QPointF(x, y);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pass the queued samples in order to f, from the consumer thread.
+    // Returns how many there were.
+    template<typename F>
+    qsizetype consume(F f)
+    {
+        const quint64 tail = m_tail.load(std::memory_order_relaxed);
+        const quint64 head = m_head.load(std::memory_order_acquire);
+        for (quint64 i = tail; i != head; ++i) {
+            f(m_ring[i & m_mask]);
+        }
+        m_tail.store(head, std::memory_order_release);
+        return qsizetype(head - tail);
+    }
+
+    // Whether samples are queued, from the consumer thread
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<QPointF> m_ring;
+    qsizetype m_mask = 0;
+    // Written by the producer: the position of the next sample, and the
+    // last tail it saw, to read the consumer's line only when it looks full
+    alignas(64) std::atomic<quint64> m_head{0};
+    quint64 m_cachedTail = 0;
+    // Written by the consumer: the position of the next sample to read
+    alignas(64) std::atomic<quint64> m_tail{0};
+};
+
+#endif
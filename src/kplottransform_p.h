@@ -0,0 +1,244 @@
+/*  -*- C++ -*-
+    This file is part of the KDE libraries
+    SPDX-FileCopyrightText: 2026 KDE Contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KPLOTTRANSFORM_P_H
+#define KPLOTTRANSFORM_P_H
+
+#include <QPointF>
+#include <QRect>
+#include <QRectF>
+
+#include <math.h>
+
+/*
+ * Clip the line segment from *p1 to *p2 to the rectangle r
+ * (Liang-Barsky).  Returns false if no part of the segment is inside r;
+ * otherwise the end points are moved onto the boundary of r as needed.
+ */
+inline bool kplotClipLine(QPointF *p1, QPointF *p2, const QRectF &r)
+{
+    const double dx = p2->x() - p1->x();
+    const double dy = p2->y() - p1->y();
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {p1->x() - r.left(), r.right() - p1->x(), p1->y() - r.top(), r.bottom() - p1->y()};
+
+    double t0 = 0.0;
+    double t1 = 1.0;
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0) {
+            // parallel to this edge
+            if (q[i] < 0.0) {
+                return false;
+            }
+        } else {
+            const double t = q[i] / p[i];
+            if (p[i] < 0.0) {
+                if (t > t1) {
+                    return false;
+                }
+                t0 = qMax(t0, t);
+            } else {
+                if (t < t0) {
+                    return false;
+                }
+                t1 = qMin(t1, t);
+            }
+        }
+    }
+
+    const QPointF start = *p1;
+    if (t1 < 1.0) {
+        *p2 = QPointF(start.x() + t1 * dx, start.y() + t1 * dy);
+    }
+    if (t0 > 0.0) {
+        *p1 = QPointF(start.x() + t0 * dx, start.y() + t0 * dy);
+    }
+    return true;
+}
+
+/*
+ * Mapping from data units to the pixel coordinates of the plot area.
+ *
+ * Each axis is either linear or logarithmic (base 10).  The mapping is
+ * reduced to one multiply-add per coordinate on the "scaled" value, which
+ * is the data value itself for linear axes and its log10 for logarithmic
+ * ones.  This lets callers map whole columns of pre-scaled values in a
+ * tight loop.
+ *
+ * A logarithmic axis only takes effect if the lower data limit is positive.
+ */
+class KPlotTransform
+{
+public:
+    KPlotTransform() = default;
+
+    KPlotTransform(const QRectF &dataRect, const QRect &pixRect, bool logX = false, bool logY = false)
+        : m_dataRect(dataRect)
+        , m_pixRect(pixRect)
+        , m_logX(logX && dataRect.left() > 0.0)
+        , m_logY(logY && dataRect.top() > 0.0)
+    {
+        const double x1 = scaleX(dataRect.left());
+        const double x2 = scaleX(dataRect.right());
+        const double y1 = scaleY(dataRect.top());
+        const double y2 = scaleY(dataRect.bottom());
+        m_sx = pixRect.width() / (x2 - x1);
+        m_ox = pixRect.left() - m_sx * x1;
+        m_sy = -pixRect.height() / (y2 - y1);
+        m_oy = pixRect.top() - m_sy * y2;
+        m_scaledRect = QRectF(QPointF(x1, y1), QPointF(x2, y2));
+    }
+
+    QRectF dataRect() const
+    {
+        return m_dataRect;
+    }
+
+    QRect pixRect() const
+    {
+        return m_pixRect;
+    }
+
+    bool isLogX() const
+    {
+        return m_logX;
+    }
+
+    bool isLogY() const
+    {
+        return m_logY;
+    }
+
+    // Data value -> scaled value (identity, or log10 for log axes)
+    double scaleX(double x) const
+    {
+        return m_logX ? log10(x) : x;
+    }
+
+    double scaleY(double y) const
+    {
+        return m_logY ? log10(y) : y;
+    }
+
+    // Scaled value -> pixel coordinate
+    double mapScaledX(double sx) const
+    {
+        return m_ox + m_sx * sx;
+    }
+
+    double mapScaledY(double sy) const
+    {
+        return m_oy + m_sy * sy;
+    }
+
+    // Data value -> pixel coordinate
+    double mapX(double x) const
+    {
+        return mapScaledX(scaleX(x));
+    }
+
+    double mapY(double y) const
+    {
+        return mapScaledY(scaleY(y));
+    }
+
+    QPointF map(const QPointF &p) const
+    {
+        return QPointF(mapX(p.x()), mapY(p.y()));
+    }
+
+    QPointF mapScaled(const QPointF &sp) const
+    {
+        return QPointF(mapScaledX(sp.x()), mapScaledY(sp.y()));
+    }
+
+    /*
+     * Clip a segment given in scaled coordinates to the data rect.
+     * See kplotClipLine().
+     */
+    bool clipScaled(QPointF *sp1, QPointF *sp2) const
+    {
+        return kplotClipLine(sp1, sp2, m_scaledRect);
+    }
+
+    // Pixel coordinate -> data value
+    double unmapX(double px) const
+    {
+        const double sx = (px - m_ox) / m_sx;
+        return m_logX ? pow(10.0, sx) : sx;
+    }
+
+    double unmapY(double py) const
+    {
+        const double sy = (py - m_oy) / m_sy;
+        return m_logY ? pow(10.0, sy) : sy;
+    }
+
+    /*
+     * Map n pre-scaled coordinate pairs to pixel positions.  Kept free of
+     * branches so the compiler can vectorize it.
+     */
+    void mapScaled(const double *sx, const double *sy, qsizetype n, QPointF *out) const
+    {
+        const double ox = m_ox;
+        const double oy = m_oy;
+        const double kx = m_sx;
+        const double ky = m_sy;
+        for (qsizetype i = 0; i < n; ++i) {
+            out[i] = QPointF(ox + kx * sx[i], oy + ky * sy[i]);
+        }
+    }
+
+    /*
+     * Returns true if this transform only differs from other by a
+     * horizontal shift of the data limits, and sets *dx to the distance in
+     * pixels that mapped points move when going from other to this one.
+     */
+    bool isShiftedX(const KPlotTransform &other, double *dx) const
+    {
+        if (m_pixRect != other.m_pixRect || m_logX != other.m_logX || m_logY != other.m_logY || m_dataRect.top() != other.m_dataRect.top()
+            || m_dataRect.height() != other.m_dataRect.height() || qAbs(m_sx - other.m_sx) > 1e-9 * qAbs(m_sx)) {
+            return false;
+        }
+        *dx = m_ox - other.m_ox;
+        return qIsFinite(*dx);
+    }
+
+    // Returns the transform which maps every point dx pixels further right
+    KPlotTransform translatedX(double dx) const
+    {
+        const double s1 = m_scaledRect.left() - dx / m_sx;
+        const double s2 = m_scaledRect.right() - dx / m_sx;
+        const double x1 = m_logX ? pow(10.0, s1) : s1;
+        const double x2 = m_logX ? pow(10.0, s2) : s2;
+        return KPlotTransform(QRectF(x1, m_dataRect.top(), x2 - x1, m_dataRect.height()), m_pixRect, m_logX, m_logY);
+    }
+
+    bool operator==(const KPlotTransform &other) const
+    {
+        return m_dataRect == other.m_dataRect && m_pixRect == other.m_pixRect && m_logX == other.m_logX && m_logY == other.m_logY;
+    }
+
+    bool operator!=(const KPlotTransform &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    QRectF m_dataRect;
+    QRect m_pixRect;
+    // dataRect in scaled coordinates
+    QRectF m_scaledRect;
+    bool m_logX = false;
+    bool m_logY = false;
+    double m_sx = 1.0;
+    double m_ox = 0.0;
+    double m_sy = -1.0;
+    double m_oy = 0.0;
+};
+
+#endif
@@ -9,87 +9,374 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <QElapsedTimer>
 #include <QHash>
 #include <QHelpEvent>
+#include <QMouseEvent>
+#include <QMutex>
 #include <QPainter>
+#include <QRegion>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QTimer>
 #include <QToolTip>
+#include <QWheelEvent>
 #include <QtAlgorithms>
 
 #include "kplotaxis.h"
+#include "kplotmask_p.h"
 #include "kplotobject.h"
+#include "kplotobject_p.h"
 #include "kplotpoint.h"
+#include "kplotrenderer.h"
+#include "kplotrenderer_p.h"
+#include "kplottransform_p.h"
 
-#define XPADDING 20
-#define YPADDING 20
-#define BIGTICKSIZE 10
-#define SMALLTICKSIZE 4
-#define TICKOFFSET 0
+// Extra pixels around the plot area in cached layers, so that they also
+// hold what the clip rect lets through at its rounded edges
+#define LAYERMARGIN 1
+// Width in device pixels of the strips that progressive rendering refines
+#define PROGRESSIVESTRIP 32
 
 class Q_DECL_HIDDEN KPlotWidget::Private
 {
 public:
     Private(KPlotWidget *qq)
         : q(qq)
-        , cBackground(Qt::black)
-        , cForeground(Qt::white)
-        , cGrid(Qt::gray)
-        , showGrid(false)
+        , rd(renderer.d.get())
         , showObjectToolTip(true)
-        , useAntialias(false)
         , autoDelete(true)
+        , cacheObjectLayers(false)
+        , cacheAxes(false)
+        , stripChart(false)
+        , parallelRendering(false)
+        , asyncRendering(false)
+        , progressiveRendering(false)
+        , frameBudget(16)
+        , adaptiveAntialias(false)
+        , interacting(false)
+        , navigationModes(NoNavigation)
+        , asyncState(std::make_shared<AsyncState>())
     {
-        // create the axes and setting their default properties
-        KPlotAxis *leftAxis = new KPlotAxis();
-        leftAxis->setTickLabelsShown(true);
-        axes.insert(LeftAxis, leftAxis);
-        KPlotAxis *bottomAxis = new KPlotAxis();
-        bottomAxis->setTickLabelsShown(true);
-        axes.insert(BottomAxis, bottomAxis);
-        KPlotAxis *rightAxis = new KPlotAxis();
-        axes.insert(RightAxis, rightAxis);
-        KPlotAxis *topAxis = new KPlotAxis();
-        axes.insert(TopAxis, topAxis);
+        asyncState->widget = qq;
+
+        idleTimer.setSingleShot(true);
+        idleTimer.setInterval(250);
+        QObject::connect(&idleTimer, &QTimer::timeout, q, [this] {
+            // The view settled, draw it antialiased again
+            interacting = false;
+            scheduleUpdate();
+        });
+
+        frameTimer.setSingleShot(true);
+        QObject::connect(&frameTimer, &QTimer::timeout, q, [this] {
+            q->update(pendingUpdate);
+            pendingUpdate = QRegion();
+            updatePending = true;
+        });
+
+        QObject::connect(&sampleTimer, &QTimer::timeout, q, [this] {
+            takeSamples();
+        });
+
+        navigationTimer.setSingleShot(true);
+        navigationTimer.setInterval(150);
+        QObject::connect(&navigationTimer, &QTimer::timeout, q, [this] {
+            // The view stopped moving, render the plot objects for it
+            if (dragMode != RubberBandDrag) {
+                navigationImage = QImage();
+                scheduleUpdate();
+            }
+        });
     }
 
     ~Private()
     {
+        // Frames still being rendered are dropped
+        {
+            QMutexLocker locker(&asyncState->mutex);
+            asyncState->widget = nullptr;
+            ++asyncState->generation;
+        }
+        for (KPlotObject *po : std::as_const(rd->objectList)) {
+            detach(po);
+        }
         if (autoDelete) {
-            qDeleteAll(objectList);
+            qDeleteAll(rd->objectList);
         }
-        qDeleteAll(axes);
     }
 
     KPlotWidget *q;
 
-    void calcDataRectLimits(double x1, double x2, double y1, double y2);
+    // Start and stop receiving the changes of po
+    void attach(KPlotObject *po);
+    void detach(KPlotObject *po);
+    // Returns the area of the plot covered by the points [first, last) of po
+    QRectF pointsArea(const KPlotObject *po, qsizetype first, qsizetype last, double reach) const;
+    // Returns the area of the plot covered by all points of po, from their extents
+    QRectF objectArea(KPlotObject *po, double reach) const;
+    // Repaint the given area of the plot
+    void updatePlotArea(const QRectF &r);
+    // Bring the cached layer of each plot object up to date
+    void updateObjectLayers();
+    // Bring the cached rendering of the axes up to date
+    void updateAxesLayer();
+    // Returns a transparent image for a plot area of the given size, laid out like the object layers
+    static QImage createLayerImage(const QSize &plotSize, qreal dpr);
     /*
-     * Returns a value indicating how well the given rectangle is
-     * avoiding masked regions in the plot.  A higher returned value
-     * indicates that the rectangle is intersecting a larger portion
-     * of the masked region, or a portion of the masked region which
-     * is weighted higher.
+     * Render objects into image, which is laid out like the object
+     * layers, by splitting it into tiles of columns that are rasterized
+     * in parallel.  Nothing is masked and no labels are placed.  Objects
+     * that are not sorted by x are drawn whole on this thread, as each
+     * tile would have to visit all of their points.
      */
-    float rectCost(const QRectF &r) const;
+    void renderTiled(const QList<KPlotObject *> &objects, QImage *image);
+    // The parallel part of renderTiled(), for objects sorted by x that
+    // are mapped already
+    void renderTiles(const QList<KPlotObject *> &objects, QImage *image);
+    // Whether some object has labels, which have to be placed serially
+    bool hasLabels(const QList<KPlotObject *> &objects) const;
+    // Pick up the points of the objects edited in place since the last paint
+    void syncPlotObjects();
+    // Draw the device pixel columns [c1, c2) of image, which is laid out
+    // like the object layers, without placing labels
+    void renderStrip(QImage *image, int c1, int c2);
+    // Whether the objects can be rendered progressively, which needs
+    // their points to be sorted by x so that each strip only visits the
+    // points within it, and no labels to place
+    bool canRenderProgressively() const;
+    // Refine the progressive frame for as long as the frame budget allows
+    void updateProgressiveFrame();
+    // Draw aliased until the view has been idle for a while, if adaptive
+    // antialiasing is on
+    void interact();
+    // Whether a layer rendered with or without antialiasing can be shown;
+    // antialiased layers stay valid while the view is changing, and only
+    // the layers that are drawn again then are aliased
+    bool layerAntialiasValid(bool antialias) const;
+    // Repaint the widget, or the region r of it, no sooner than the
+    // maximum frame rate allows and once the current batch of changes ends
+    void scheduleUpdate();
+    void scheduleUpdate(const QRegion &r);
 
-    // Colors
-    QColor cBackground, cForeground, cGrid;
+    /*
+     * Fit the limits to the extents of the plot objects, if autoscaling is
+     * on and they are out of the range the hysteresis allows.  Returns
+     * whether the limits changed.
+     */
+    bool applyAutoScale();
+    /*
+     * Returns in n1, n2 the limits for the data range [d1, d2] if the
+     * limits [c1, c2] do not fit it, or false if they do.
+     */
+    bool autoScaleRange(double d1, double d2, double c1, double c2, bool log, double *n1, double *n2) const;
+
+    // Start taking the samples queued in the plot objects once a frame,
+    // or stop if none has a queue
+    void updateSampleTimer();
+    // Add the samples queued in the plot objects as points
+    void takeSamples();
+
+    // Returns the position in the plot area of the widget position pos
+    QPoint plotPosition(const QPointF &pos) const;
+    // Keep the current rendering of the plot objects in navigationImage
+    // for the steps of a navigation, unless one is kept already
+    void beginNavigation();
+    // Set the limits to what the rectangle r of the plot area of t shows
+    void navigateTo(const KPlotTransform &t, const QRectF &r);
+    // A step of a navigation: move the view to r of the current plot area
+    // without rendering the plot objects again until the view settles
+    void navigationStep(const KPlotTransform &t, const QRectF &r);
+    // Draw navigationImage scaled and moved to the current limits
+    void drawNavigationImage(QPainter *p) const;
+
+    // The plot description and the drawing code
+    KPlotRenderer renderer;
+    // The state of renderer: data limits, axes, objects, colors, ...
+    KPlotRenderer::Private *const rd;
     // draw options
-    bool showGrid;
     bool showObjectToolTip;
-    bool useAntialias;
     bool autoDelete;
-    // padding
-    int leftPadding, rightPadding, topPadding, bottomPadding;
-    // hashmap with the axes we have
-    QHash<Axis, KPlotAxis *> axes;
-    // List of KPlotObjects
-    QList<KPlotObject *> objectList;
-    // Limits of the plot area in data units
-    QRectF dataRect, secondDataRect;
-    // Limits of the plot area in pixel units
-    QRect pixRect;
-    // Array holding the mask of "used" regions of the plot
-    QImage plotMask;
+    bool cacheObjectLayers;
+    bool cacheAxes;
+    bool stripChart;
+    bool parallelRendering;
+    bool asyncRendering;
+    bool progressiveRendering;
+    // Time in milliseconds that a paint may spend on refining
+    int frameBudget;
+    bool adaptiveAntialias;
+    // Whether the view changed during the idle delay of adaptive antialiasing
+    bool interacting;
+    QTimer idleTimer;
+
+    // Frames per second that repaints are held to, 0 for no limit
+    int maximumFrameRate = 0;
+    // Measures the time since the last paint
+    QElapsedTimer frameClock;
+    // Whether a repaint was requested from Qt and has not happened yet
+    bool updatePending = false;
+    // Delays the repaint until the next frame is due, and the region it
+    // will repaint
+    QTimer frameTimer;
+    QRegion pendingUpdate;
+    qint64 mergedUpdates = 0;
+    // Nesting of beginUpdate(), and what to repaint when the outermost
+    // update ends
+    int updateDepth = 0;
+    QRegion deferredUpdate;
+    QTimer sampleTimer;
+
+    bool autoScale = false;
+    double autoScalePadding = 0.05;
+    double autoScaleHysteresis = 0.1;
+
+    NavigationModes navigationModes;
+    // Restarted by each step of a navigation; the plot objects are
+    // rendered again when it fires
+    QTimer navigationTimer;
+    // The rendering of the plot objects shown during a navigation, laid
+    // out like the object layers, and the transform it was made for
+    QImage navigationImage;
+    KPlotTransform navigationTransform;
+    enum DragMode {
+        NoDrag,
+        PanDrag,
+        RubberBandDrag,
+    };
+    DragMode dragMode = NoDrag;
+    // Where the drag started in the plot area, and the transform then
+    QPoint dragStart;
+    KPlotTransform dragTransform;
+    // The rectangle being dragged out in the plot area
+    QRect rubberBand;
+
+    // Cached rendering of a single plot object
+    struct ObjectLayer {
+        QImage image;
+        // The state the image was rendered for
+        quint64 revision = 0;
+        quint64 resetRevision = 0;
+        qsizetype pointCount = 0;
+        KPlotTransform transform;
+        // Pixels by which the image is drawn to the right of transform,
+        // after being scrolled by whole pixels only
+        double residual = 0.0;
+        bool antialias = false;
+        qreal devicePixelRatio = 1.0;
+    };
+    QHash<KPlotObject *, ObjectLayer> objectLayers;
+    /*
+     * Bring the layer of po up to date for a transform that was only
+     * shifted horizontally, by scrolling it and drawing the exposed strip
+     * and the points appended since it was rendered.  Returns false if
+     * the layer cannot be updated that way.
+     */
+    bool scrollObjectLayer(KPlotObject *po, ObjectLayer &layer);
+    // What of each object's style the area of a change depends on,
+    // as of its last change
+    struct ObjectStyle {
+        double reach = 0.0;
+        bool bars = false;
+    };
+    static ObjectStyle objectStyle(const KPlotObject *po);
+    QHash<KPlotObject *, ObjectStyle> objectStyles;
+
+    // The state of an axis that its rendering depends on
+    struct AxisState {
+        bool visible = false;
+        bool showTickLabels = false;
+        char labelFormat = 'g';
+        int labelFieldWidth = 0;
+        int labelPrecision = -1;
+        QString label;
+        QList<double> majorTickMarks, minorTickMarks;
+
+        bool operator==(const AxisState &o) const
+        {
+            return visible == o.visible && showTickLabels == o.showTickLabels && labelFormat == o.labelFormat && labelFieldWidth == o.labelFieldWidth
+                && labelPrecision == o.labelPrecision && label == o.label && majorTickMarks == o.majorTickMarks && minorTickMarks == o.minorTickMarks;
+        }
+    };
+
+    // The state of the widget that the rendering of the axes depends on
+    struct AxesState {
+        QSize size;
+        QPoint origin;
+        KPlotTransform transform;
+        QRectF secondDataRect;
+        bool showGrid = false;
+        bool antialias = false;
+        QColor background, foreground, grid;
+        QFont font;
+        qreal devicePixelRatio = 1.0;
+        AxisState axes[4];
+
+        bool operator==(const AxesState &o) const
+        {
+            return size == o.size && origin == o.origin && transform == o.transform && secondDataRect == o.secondDataRect && showGrid == o.showGrid
+                && antialias == o.antialias && background == o.background && foreground == o.foreground && grid == o.grid && font == o.font
+                && devicePixelRatio == o.devicePixelRatio
+                && std::equal(axes, axes + 4, o.axes);
+        }
+    };
+    AxesState axesState() const;
+
+    // Cached rendering of the grid, the axes and their labels
+    QImage axesLayer;
+    AxesState axesLayerState;
+
+    // The state that a frame of the plot objects is rendered for
+    struct FrameState {
+        KPlotTransform transform;
+        bool antialias = false;
+        qreal devicePixelRatio = 1.0;
+        QFont font;
+        // The revisions of the objects, which are unique across objects
+        QList<quint64> revisions;
+
+        bool operator==(const FrameState &o) const
+        {
+            return transform == o.transform && antialias == o.antialias && devicePixelRatio == o.devicePixelRatio && font == o.font
+                && revisions == o.revisions;
+        }
+    };
+    FrameState frameState() const;
+    // Start rendering a frame on a worker thread, unless one was already
+    // requested for the current state.  Only one frame is rendered at a
+    // time; the requests made meanwhile are merged into the next frame,
+    // which is started once the current one is presented.
+    void requestFrame();
+
+    // State shared with the threads rendering frames, which outlives the widget
+    struct AsyncState {
+        QMutex mutex;
+        // Cleared when the widget is destroyed
+        KPlotWidget *widget = nullptr;
+        // Bumped when the frames in flight are dropped, so that they stop
+        // early
+        std::atomic<quint64> generation{0};
+    };
+    std::shared_ptr<AsyncState> asyncState;
+    FrameState requestedFrame;
+    bool frameRequested = false;
+    // Whether a frame is being rendered
+    bool frameInFlight = false;
+    // The latest completed frame, laid out like the object layers
+    QImage asyncFrame;
+
+    // The frame of progressive rendering, laid out like the object layers;
+    // its columns before progressiveColumn are fully rendered, the others
+    // show a preview from decimated objects
+    QImage progressiveFrame;
+    FrameState progressiveState;
+    int progressiveColumn = 0;
 };
 
 KPlotWidget::KPlotWidget(QWidget *parent)
@@ -98,12 +385,6 @@ KPlotWidget::KPlotWidget(QWidget *parent)
 {
     setAttribute(Qt::WA_OpaquePaintEvent);
     setAttribute(Qt::WA_NoSystemBackground);
-
-    d->secondDataRect = QRectF(); // default: no secondary data rect
-    // sets the default limits
-    d->calcDataRectLimits(0.0, 1.0, 0.0, 1.0);
-
-    setDefaultPaddings();
 }
 
 KPlotWidget::~KPlotWidget() = default;
@@ -120,104 +401,225 @@ QSize KPlotWidget::sizeHint() const
 
 void KPlotWidget::setLimits(double x1, double x2, double y1, double y2)
 {
-    d->calcDataRectLimits(x1, x2, y1, y2);
-    update();
+    d->renderer.setLimits(x1, x2, y1, y2);
+    d->interact();
+    d->scheduleUpdate();
 }
 
-void KPlotWidget::Private::calcDataRectLimits(double x1, double x2, double y1, double y2)
+void KPlotWidget::Private::attach(KPlotObject *po)
 {
-    double XA1;
-    double XA2;
-    double YA1;
-    double YA2;
-    if (x2 < x1) {
-        XA1 = x2;
-        XA2 = x1;
-    } else {
-        XA1 = x1;
-        XA2 = x2;
+    if (!po->d->widgets.contains(q)) {
+        po->d->widgets.append(q);
     }
-    if (y2 < y1) {
-        YA1 = y2;
-        YA2 = y1;
-    } else {
-        YA1 = y1;
-        YA2 = y2;
+    objectStyles.insert(po, objectStyle(po));
+    if (po->d->sampleQueue) {
+        updateSampleTimer();
     }
+}
+
+void KPlotWidget::Private::detach(KPlotObject *po)
+{
+    po->d->widgets.removeAll(q);
+    objectStyles.remove(po);
+}
 
-    if (XA2 == XA1) {
-        // qWarning() << "x1 and x2 cannot be equal. Setting x2 = x1 + 1.0";
-        XA2 = XA1 + 1.0;
+KPlotWidget::Private::ObjectStyle KPlotWidget::Private::objectStyle(const KPlotObject *po)
+{
+    ObjectStyle style;
+    style.reach = po->d->reach();
+    style.bars = po->d->type & KPlotObject::Bars;
+    return style;
+}
+
+QRectF KPlotWidget::Private::pointsArea(const KPlotObject *po, qsizetype first, qsizetype last, double reach) const
+{
+    const KPlotObject::Private *od = po->d.get();
+    double x1 = qInf();
+    double x2 = -qInf();
+    double y1 = qInf();
+    double y2 = -qInf();
+    for (qsizetype i = first; i < last; ++i) {
+        const QPointF p = rd->transform.map(QPointF(od->xAt(i), od->yColumn[i]));
+        if (!qIsFinite(p.x()) || !qIsFinite(p.y())) {
+            continue;
+        }
+        x1 = qMin(x1, p.x());
+        x2 = qMax(x2, p.x());
+        y1 = qMin(y1, p.y());
+        y2 = qMax(y2, p.y());
     }
-    if (YA2 == YA1) {
-        // qWarning() << "y1 and y2 cannot be equal. Setting y2 = y1 + 1.0";
-        YA2 = YA1 + 1.0;
+    if (x1 > x2) {
+        return QRectF();
     }
-    dataRect = QRectF(XA1, YA1, XA2 - XA1, YA2 - YA1);
+    return QRectF(QPointF(x1, y1), QPointF(x2, y2)).adjusted(-reach, -reach, reach, reach);
+}
 
-    q->axis(LeftAxis)->setTickMarks(dataRect.y(), dataRect.height());
-    q->axis(BottomAxis)->setTickMarks(dataRect.x(), dataRect.width());
+QRectF KPlotWidget::Private::objectArea(KPlotObject *po, double reach) const
+{
+    double x1;
+    double x2;
+    double y1;
+    double y2;
+    if (!po->d->extents(&x1, &x2, &y1, &y2)) {
+        return QRectF();
+    }
+    // The mapping is monotonic, so the corners bound the points.  Extents
+    // reaching out of a log axis cannot be mapped, and any point may be
+    // in view then.
+    const QPointF p1 = rd->transform.map(QPointF(x1, y1));
+    const QPointF p2 = rd->transform.map(QPointF(x2, y2));
+    if (!qIsFinite(p1.x()) || !qIsFinite(p1.y()) || !qIsFinite(p2.x()) || !qIsFinite(p2.y())) {
+        return QRectF(rd->pixRect);
+    }
+    return QRectF(p1, p2).normalized().adjusted(-reach, -reach, reach, reach);
+}
 
-    if (secondDataRect.isNull()) {
-        q->axis(RightAxis)->setTickMarks(dataRect.y(), dataRect.height());
-        q->axis(TopAxis)->setTickMarks(dataRect.x(), dataRect.width());
+void KPlotWidget::Private::updatePlotArea(const QRectF &r)
+{
+    // The plot is drawn at an offset of the paddings, see paintEvent()
+    const QRectF area = r.intersected(QRectF(rd->pixRect).adjusted(-LAYERMARGIN, -LAYERMARGIN, LAYERMARGIN, LAYERMARGIN));
+    if (area.isEmpty()) {
+        return;
     }
+    scheduleUpdate(area.translated(q->leftPadding(), q->topPadding()).toAlignedRect().adjusted(-1, -1, 1, 1));
 }
 
-void KPlotWidget::setSecondaryLimits(double x1, double x2, double y1, double y2)
+bool KPlotWidget::autoScaling() const
 {
-    double XA1;
-    double XA2;
-    double YA1;
-    double YA2;
-    if (x2 < x1) {
-        XA1 = x2;
-        XA2 = x1;
-    } else {
-        XA1 = x1;
-        XA2 = x2;
+    return d->autoScale;
+}
+
+void KPlotWidget::setAutoScaling(bool b)
+{
+    d->autoScale = b;
+    if (d->applyAutoScale()) {
+        d->scheduleUpdate();
     }
-    if (y2 < y1) {
-        YA1 = y2;
-        YA2 = y1;
-    } else {
-        YA1 = y1;
-        YA2 = y2;
+}
+
+double KPlotWidget::autoScalePadding() const
+{
+    return d->autoScalePadding;
+}
+
+void KPlotWidget::setAutoScalePadding(double padding)
+{
+    d->autoScalePadding = qMax(padding, 0.0);
+    if (d->applyAutoScale()) {
+        d->scheduleUpdate();
+    }
+}
+
+double KPlotWidget::autoScaleHysteresis() const
+{
+    return d->autoScaleHysteresis;
+}
+
+void KPlotWidget::setAutoScaleHysteresis(double hysteresis)
+{
+    d->autoScaleHysteresis = qMax(hysteresis, 0.0);
+    if (d->applyAutoScale()) {
+        d->scheduleUpdate();
+    }
+}
+
+bool KPlotWidget::Private::autoScaleRange(double d1, double d2, double c1, double c2, bool log, double *n1, double *n2) const
+{
+    log = log && d1 > 0.0 && c1 > 0.0;
+    if (log) {
+        d1 = log10(d1);
+        d2 = log10(d2);
+        c1 = log10(c1);
+        c2 = log10(c2);
+    }
+    // A single value is given a unit range, like setLimits() does
+    const double extent = d2 > d1 ? d2 - d1 : 1.0;
+    // Allow for the rounding of the limits when they are stored
+    const double slack = 1e-9 * extent;
+    const double inner = autoScalePadding * extent - slack;
+    const double outer = (autoScalePadding + 2 * autoScaleHysteresis) * extent + slack;
+    if (c1 <= d1 - inner && c1 >= d1 - outer && c2 >= d2 + inner && c2 <= d2 + outer) {
+        return false;
+    }
+    const double margin = (autoScalePadding + autoScaleHysteresis) * extent;
+    *n1 = d1 - margin;
+    *n2 = d2 + margin;
+    if (log) {
+        *n1 = pow(10.0, *n1);
+        *n2 = pow(10.0, *n2);
     }
+    return true;
+}
 
-    if (XA2 == XA1) {
-        // qWarning() << "x1 and x2 cannot be equal. Setting x2 = x1 + 1.0";
-        XA2 = XA1 + 1.0;
+bool KPlotWidget::Private::applyAutoScale()
+{
+    if (!autoScale) {
+        return false;
+    }
+    double x1 = qInf();
+    double x2 = -qInf();
+    double y1 = qInf();
+    double y2 = -qInf();
+    for (KPlotObject *po : std::as_const(rd->objectList)) {
+        double ox1, ox2, oy1, oy2;
+        if (po->d->extents(&ox1, &ox2, &oy1, &oy2)) {
+            x1 = qMin(x1, ox1);
+            x2 = qMax(x2, ox2);
+            y1 = qMin(y1, oy1);
+            y2 = qMax(y2, oy2);
+        }
     }
-    if (YA2 == YA1) {
-        // qWarning() << "y1 and y2 cannot be equal. Setting y2 = y1 + 1.0";
-        YA2 = YA1 + 1.0;
+    if (x1 > x2) {
+        return false;
     }
-    d->secondDataRect = QRectF(XA1, YA1, XA2 - XA1, YA2 - YA1);
 
-    axis(RightAxis)->setTickMarks(d->secondDataRect.y(), d->secondDataRect.height());
-    axis(TopAxis)->setTickMarks(d->secondDataRect.x(), d->secondDataRect.width());
+    const QRectF &r = rd->dataRect;
+    double nx1 = r.left();
+    double nx2 = r.right();
+    double ny1 = r.top();
+    double ny2 = r.bottom();
+    const bool changedX = autoScaleRange(x1, x2, r.left(), r.right(), rd->logX, &nx1, &nx2);
+    const bool changedY = autoScaleRange(y1, y2, r.top(), r.bottom(), rd->logY, &ny1, &ny2);
+    if (!changedX && !changedY) {
+        return false;
+    }
+    renderer.setLimits(nx1, nx2, ny1, ny2);
+    Q_EMIT q->limitsChanged(rd->dataRect);
+    return true;
+}
 
-    update();
+void KPlotWidget::setSecondaryLimits(double x1, double x2, double y1, double y2)
+{
+    d->renderer.setSecondaryLimits(x1, x2, y1, y2);
+    d->scheduleUpdate();
 }
 
 void KPlotWidget::clearSecondaryLimits()
 {
-    d->secondDataRect = QRectF();
-    axis(RightAxis)->setTickMarks(d->dataRect.y(), d->dataRect.height());
-    axis(TopAxis)->setTickMarks(d->dataRect.x(), d->dataRect.width());
+    d->renderer.clearSecondaryLimits();
+    d->scheduleUpdate();
+}
+
+bool KPlotWidget::isLogScale(Qt::Orientation orientation) const
+{
+    return d->renderer.isLogScale(orientation);
+}
 
-    update();
+void KPlotWidget::setLogScale(Qt::Orientation orientation, bool log)
+{
+    d->renderer.setLogScale(orientation, log);
+    d->applyAutoScale();
+    d->scheduleUpdate();
 }
 
 QRectF KPlotWidget::dataRect() const
 {
-    return d->dataRect;
+    return d->renderer.dataRect();
 }
 
 QRectF KPlotWidget::secondaryDataRect() const
 {
-    return d->secondDataRect;
+    return d->renderer.secondaryDataRect();
 }
 
 void KPlotWidget::addPlotObject(KPlotObject *object)
@@ -226,8 +628,10 @@ void KPlotWidget::addPlotObject(KPlotObject *object)
     if (!object) {
         return;
     }
-    d->objectList.append(object);
-    update();
+    d->renderer.addPlotObject(object);
+    d->attach(object);
+    d->applyAutoScale();
+    d->scheduleUpdate();
 }
 
 void KPlotWidget::addPlotObjects(const QList<KPlotObject *> &objects)
@@ -238,17 +642,19 @@ void KPlotWidget::addPlotObjects(const QList<KPlotObject *> &objects)
             continue;
         }
 
-        d->objectList.append(o);
+        d->renderer.addPlotObject(o);
+        d->attach(o);
         addedsome = true;
     }
     if (addedsome) {
-        update();
+        d->applyAutoScale();
+        d->scheduleUpdate();
     }
 }
 
 QList<KPlotObject *> KPlotWidget::plotObjects() const
 {
-    return d->objectList;
+    return d->renderer.plotObjects();
 }
 
 void KPlotWidget::setAutoDeletePlotObjects(bool autoDelete)
@@ -258,33 +664,37 @@ void KPlotWidget::setAutoDeletePlotObjects(bool autoDelete)
 
 void KPlotWidget::removeAllPlotObjects()
 {
-    if (d->objectList.isEmpty()) {
+    if (d->rd->objectList.isEmpty()) {
         return;
     }
 
+    for (KPlotObject *o : std::as_const(d->rd->objectList)) {
+        d->detach(o);
+    }
     if (d->autoDelete) {
-        qDeleteAll(d->objectList);
+        qDeleteAll(d->rd->objectList);
     }
-    d->objectList.clear();
-    update();
+    d->renderer.removeAllPlotObjects();
+    d->applyAutoScale();
+    d->scheduleUpdate();
 }
 
 void KPlotWidget::resetPlotMask()
 {
-    d->plotMask = QImage(pixRect().size(), QImage::Format_ARGB32);
-    QColor fillColor = Qt::black;
-    fillColor.setAlpha(128);
-    d->plotMask.fill(fillColor.rgb());
+    d->renderer.resetPlotMask();
 }
 
 void KPlotWidget::resetPlot()
 {
+    for (KPlotObject *o : std::as_const(d->rd->objectList)) {
+        d->detach(o);
+    }
     if (d->autoDelete) {
-        qDeleteAll(d->objectList);
+        qDeleteAll(d->rd->objectList);
     }
-    d->objectList.clear();
+    d->renderer.removeAllPlotObjects();
     clearSecondaryLimits();
-    d->calcDataRectLimits(0.0, 1.0, 0.0, 1.0);
+    d->renderer.setLimits(0.0, 1.0, 0.0, 1.0);
     KPlotAxis *a = axis(RightAxis);
     a->setLabel(QString());
     a->setTickLabelsShown(false);
@@ -299,55 +709,103 @@ void KPlotWidget::resetPlot()
 void KPlotWidget::replacePlotObject(int i, KPlotObject *o)
 {
     // skip null pointers and invalid indexes
-    if (!o || i < 0 || i >= d->objectList.count()) {
+    if (!o || i < 0 || i >= d->rd->objectList.count()) {
         return;
     }
-    if (d->objectList.at(i) == o) {
+    if (d->rd->objectList.at(i) == o) {
         return;
     }
+    KPlotObject *old = d->rd->objectList.at(i);
+    d->renderer.replacePlotObject(i, o);
+    if (!d->rd->objectList.contains(old)) {
+        d->detach(old);
+    }
     if (d->autoDelete) {
-        delete d->objectList.at(i);
+        delete old;
     }
-    d->objectList.replace(i, o);
-    update();
+    d->attach(o);
+    d->applyAutoScale();
+    d->scheduleUpdate();
+}
+
+void KPlotWidget::plotObjectChanged(KPlotObject *object, qsizetype first)
+{
+    d->interact();
+    object->d->syncColumns();
+
+    const KPlotObject::Private *od = object->d.get();
+    const Private::ObjectStyle oldStyle = d->objectStyles.value(object);
+    const Private::ObjectStyle style = Private::objectStyle(object);
+    d->objectStyles.insert(object, style);
+
+    if (d->applyAutoScale()) {
+        d->scheduleUpdate();
+        return;
+    }
+
+    // Labels are placed around the points of the same object, or of all
+    // objects without layer caching, and bars depend on the next point;
+    // a change can then affect any part of the plot.
+    bool local = first >= 0 && od->labelCount == 0 && !style.bars && !oldStyle.bars;
+    if (local && !(d->cacheObjectLayers || d->stripChart)) {
+        for (const KPlotObject *po : std::as_const(d->rd->objectList)) {
+            if (po->d->labelCount > 0) {
+                local = false;
+                break;
+            }
+        }
+    }
+    if (!local) {
+        d->updatePlotArea(QRectF(d->rd->pixRect));
+        return;
+    }
+
+    const double reach = qMax(style.reach, oldStyle.reach);
+    if (first == 0) {
+        // A change of style, or all points new
+        d->updatePlotArea(d->objectArea(object, reach));
+        return;
+    }
+    // Include the line joining the first changed point to the previous one
+    d->updatePlotArea(d->pointsArea(object, first - 1, od->count(), reach));
 }
 
 QColor KPlotWidget::backgroundColor() const
 {
-    return d->cBackground;
+    return d->renderer.backgroundColor();
 }
 
 QColor KPlotWidget::foregroundColor() const
 {
-    return d->cForeground;
+    return d->renderer.foregroundColor();
 }
 
 QColor KPlotWidget::gridColor() const
 {
-    return d->cGrid;
+    return d->renderer.gridColor();
 }
 
 void KPlotWidget::setBackgroundColor(const QColor &bg)
 {
-    d->cBackground = bg;
-    update();
+    d->renderer.setBackgroundColor(bg);
+    d->scheduleUpdate();
 }
 
 void KPlotWidget::setForegroundColor(const QColor &fg)
 {
-    d->cForeground = fg;
-    update();
+    d->renderer.setForegroundColor(fg);
+    d->scheduleUpdate();
 }
 
 void KPlotWidget::setGridColor(const QColor &gc)
 {
-    d->cGrid = gc;
-    update();
+    d->renderer.setGridColor(gc);
+    d->scheduleUpdate();
 }
 
 bool KPlotWidget::isGridShown() const
 {
-    return d->showGrid;
+    return d->renderer.isGridShown();
 }
 
 bool KPlotWidget::isObjectToolTipShown() const
@@ -357,19 +815,382 @@ bool KPlotWidget::isObjectToolTipShown() const
 
 bool KPlotWidget::antialiasing() const
 {
-    return d->useAntialias;
+    return d->renderer.antialiasing();
 }
 
 void KPlotWidget::setAntialiasing(bool b)
 {
-    d->useAntialias = b;
-    update();
+    d->renderer.setAntialiasing(b);
+    d->scheduleUpdate();
+}
+
+bool KPlotWidget::adaptiveAntialiasing() const
+{
+    return d->adaptiveAntialias;
+}
+
+void KPlotWidget::setAdaptiveAntialiasing(bool b)
+{
+    d->adaptiveAntialias = b;
+    if (!b && d->interacting) {
+        d->idleTimer.stop();
+        d->interacting = false;
+        d->scheduleUpdate();
+    }
+}
+
+int KPlotWidget::antialiasingDelay() const
+{
+    return d->idleTimer.interval();
+}
+
+void KPlotWidget::setAntialiasingDelay(int msec)
+{
+    d->idleTimer.setInterval(qMax(msec, 0));
+}
+
+void KPlotWidget::Private::interact()
+{
+    if (!adaptiveAntialias || !rd->useAntialias) {
+        return;
+    }
+    interacting = true;
+    idleTimer.start();
+}
+
+bool KPlotWidget::Private::layerAntialiasValid(bool antialias) const
+{
+    return antialias == rd->useAntialias || (interacting && antialias);
+}
+
+int KPlotWidget::maximumFrameRate() const
+{
+    return d->maximumFrameRate;
+}
+
+void KPlotWidget::setMaximumFrameRate(int fps)
+{
+    d->maximumFrameRate = qMax(fps, 0);
+    if (d->sampleTimer.isActive()) {
+        d->updateSampleTimer();
+    }
+    if (d->maximumFrameRate == 0 && d->frameTimer.isActive()) {
+        d->frameTimer.stop();
+        update(d->pendingUpdate);
+        d->pendingUpdate = QRegion();
+    }
+}
+
+qint64 KPlotWidget::mergedUpdateCount() const
+{
+    return d->mergedUpdates;
+}
+
+void KPlotWidget::sampleQueueChanged()
+{
+    d->updateSampleTimer();
+}
+
+void KPlotWidget::plotObjectDestroyed(KPlotObject *object)
+{
+    d->rd->objectList.removeAll(object);
+    d->objectStyles.remove(object);
+    d->objectLayers.remove(object);
+    d->updateSampleTimer();
+    d->applyAutoScale();
+    d->scheduleUpdate();
+}
+
+void KPlotWidget::Private::updateSampleTimer()
+{
+    const bool queued = std::any_of(rd->objectList.cbegin(), rd->objectList.cend(), [](const KPlotObject *po) {
+        return po->d->sampleQueue != nullptr;
+    });
+    if (!queued) {
+        sampleTimer.stop();
+        return;
+    }
+    // Without a frame rate limit, take them about as often as a display refreshes
+    sampleTimer.setInterval(maximumFrameRate > 0 ? 1000 / maximumFrameRate : 16);
+    if (!sampleTimer.isActive()) {
+        sampleTimer.start();
+    }
+}
+
+void KPlotWidget::Private::takeSamples()
+{
+    bool queued = false;
+    q->beginUpdate();
+    for (KPlotObject *po : std::as_const(rd->objectList)) {
+        if (po->d->sampleQueue) {
+            po->takeSamples();
+            queued = true;
+        }
+    }
+    q->endUpdate();
+    if (!queued) {
+        sampleTimer.stop();
+    }
+}
+
+void KPlotWidget::Private::scheduleUpdate()
+{
+    scheduleUpdate(QRegion(q->rect()));
+}
+
+void KPlotWidget::Private::scheduleUpdate(const QRegion &r)
+{
+    if (updateDepth > 0) {
+        deferredUpdate += r;
+        return;
+    }
+    if (maximumFrameRate == 0) {
+        q->update(r);
+        return;
+    }
+
+    // A repaint that is already due takes this one along
+    if (updatePending || frameTimer.isActive()) {
+        ++mergedUpdates;
+    }
+    if (frameTimer.isActive()) {
+        pendingUpdate += r;
+        return;
+    }
+
+    const qint64 interval = 1000 / maximumFrameRate;
+    const qint64 elapsed = frameClock.isValid() ? frameClock.elapsed() : interval;
+    if (elapsed >= interval) {
+        q->update(r);
+        updatePending = true;
+        return;
+    }
+    pendingUpdate = r;
+    frameTimer.start(int(interval - elapsed));
+}
+
+void KPlotWidget::beginUpdate()
+{
+    if (d->updateDepth++ == 0) {
+        d->rd->deferTickMarks = true;
+    }
+}
+
+void KPlotWidget::endUpdate()
+{
+    if (d->updateDepth == 0 || --d->updateDepth > 0) {
+        return;
+    }
+    d->rd->deferTickMarks = false;
+    d->rd->ensureTickMarks();
+    if (!d->deferredUpdate.isEmpty()) {
+        const QRegion r = d->deferredUpdate;
+        d->deferredUpdate = QRegion();
+        d->scheduleUpdate(r);
+    }
+}
+
+bool KPlotWidget::isUpdating() const
+{
+    return d->updateDepth > 0;
+}
+
+KPlotWidget::NavigationModes KPlotWidget::navigationModes() const
+{
+    return d->navigationModes;
+}
+
+void KPlotWidget::setNavigationModes(NavigationModes modes)
+{
+    d->navigationModes = modes;
+}
+
+int KPlotWidget::navigationDelay() const
+{
+    return d->navigationTimer.interval();
+}
+
+void KPlotWidget::setNavigationDelay(int msec)
+{
+    d->navigationTimer.setInterval(qMax(msec, 0));
+}
+
+QPoint KPlotWidget::Private::plotPosition(const QPointF &pos) const
+{
+    return pos.toPoint() - QPoint(q->leftPadding(), q->topPadding()) - q->contentsRect().topLeft();
+}
+
+void KPlotWidget::Private::beginNavigation()
+{
+    if (!navigationImage.isNull()) {
+        return;
+    }
+
+    q->setPixRect();
+    navigationTransform = rd->transform;
+    if (canRenderProgressively() && !progressiveFrame.isNull() && progressiveState.transform == rd->transform) {
+        // What is on screen, even if not refined everywhere yet
+        navigationImage = progressiveFrame;
+        return;
+    }
+
+    navigationImage = createLayerImage(rd->pixRect.size(), q->devicePixelRatioF());
+    QPainter p(&navigationImage);
+    if (cacheObjectLayers || stripChart) {
+        updateObjectLayers();
+        for (KPlotObject *po : std::as_const(rd->objectList)) {
+            p.drawImage(QPoint(0, 0), objectLayers.value(po).image);
+        }
+    } else {
+        p.setRenderHint(QPainter::Antialiasing, rd->useAntialias);
+        p.setFont(q->font());
+        p.translate(LAYERMARGIN + 0.5, LAYERMARGIN + 0.5);
+        renderer.drawPlotObjects(&p);
+    }
+}
+
+void KPlotWidget::Private::navigateTo(const KPlotTransform &t, const QRectF &r)
+{
+    // The user takes over from autoscaling
+    autoScale = false;
+    // Pixel y grows downwards, data y upwards
+    q->setLimits(t.unmapX(r.left()), t.unmapX(r.right()), t.unmapY(r.bottom()), t.unmapY(r.top()));
+    Q_EMIT q->limitsChanged(rd->dataRect);
+}
+
+void KPlotWidget::Private::navigationStep(const KPlotTransform &t, const QRectF &r)
+{
+    beginNavigation();
+    navigateTo(t, r);
+    navigationTimer.start();
+}
+
+void KPlotWidget::Private::drawNavigationImage(QPainter *p) const
+{
+    const KPlotTransform &t = rd->transform;
+    const QRect r = navigationTransform.pixRect();
+    if (r.width() <= 0 || r.height() <= 0) {
+        return;
+    }
+
+    // The old plot area maps linearly to the new one, also on logarithmic
+    // axes; find where its edges are now
+    const double x1 = t.mapX(navigationTransform.unmapX(r.left()));
+    const double x2 = t.mapX(navigationTransform.unmapX(r.left() + r.width()));
+    const double y1 = t.mapY(navigationTransform.unmapY(r.top()));
+    const double y2 = t.mapY(navigationTransform.unmapY(r.top() + r.height()));
+    const double sx = (x2 - x1) / r.width();
+    const double sy = (y2 - y1) / r.height();
+    if (!qIsFinite(sx) || !qIsFinite(sy)) {
+        return;
+    }
+
+    p->save();
+    p->setClipRect(rd->pixRect);
+    p->translate(x1 - sx * r.left(), y1 - sy * r.top());
+    p->scale(sx, sy);
+    p->drawImage(QPointF(-LAYERMARGIN - 0.5, -LAYERMARGIN - 0.5), navigationImage);
+    p->restore();
+}
+
+bool KPlotWidget::objectLayerCaching() const
+{
+    return d->cacheObjectLayers;
+}
+
+void KPlotWidget::setObjectLayerCaching(bool b)
+{
+    d->cacheObjectLayers = b;
+    if (!b && !d->stripChart) {
+        d->objectLayers.clear();
+    }
+    d->scheduleUpdate();
+}
+
+bool KPlotWidget::parallelRendering() const
+{
+    return d->parallelRendering;
+}
+
+void KPlotWidget::setParallelRendering(bool b)
+{
+    d->parallelRendering = b;
+    d->scheduleUpdate();
+}
+
+bool KPlotWidget::asyncRendering() const
+{
+    return d->asyncRendering;
+}
+
+void KPlotWidget::setAsyncRendering(bool b)
+{
+    d->asyncRendering = b;
+    if (!b) {
+        // Drop the frames in flight and the last one
+        ++d->asyncState->generation;
+        d->frameRequested = false;
+        d->frameInFlight = false;
+        d->asyncFrame = QImage();
+    }
+    d->scheduleUpdate();
+}
+
+bool KPlotWidget::progressiveRendering() const
+{
+    return d->progressiveRendering;
+}
+
+void KPlotWidget::setProgressiveRendering(bool b)
+{
+    d->progressiveRendering = b;
+    if (!b) {
+        d->progressiveFrame = QImage();
+    }
+    d->scheduleUpdate();
+}
+
+int KPlotWidget::frameBudget() const
+{
+    return d->frameBudget;
+}
+
+void KPlotWidget::setFrameBudget(int msec)
+{
+    d->frameBudget = qMax(msec, 0);
+}
+
+bool KPlotWidget::stripChartMode() const
+{
+    return d->stripChart;
+}
+
+void KPlotWidget::setStripChartMode(bool b)
+{
+    d->stripChart = b;
+    // Layers that were scrolled are only accurate to half a pixel
+    d->objectLayers.clear();
+    d->scheduleUpdate();
+}
+
+bool KPlotWidget::axesCaching() const
+{
+    return d->cacheAxes;
+}
+
+void KPlotWidget::setAxesCaching(bool b)
+{
+    d->cacheAxes = b;
+    if (!b) {
+        d->axesLayer = QImage();
+    }
+    d->scheduleUpdate();
 }
 
 void KPlotWidget::setShowGrid(bool show)
 {
-    d->showGrid = show;
-    update();
+    d->renderer.setShowGrid(show);
+    d->scheduleUpdate();
 }
 
 void KPlotWidget::setObjectToolTipShown(bool show)
@@ -379,44 +1200,50 @@ void KPlotWidget::setObjectToolTipShown(bool show)
 
 KPlotAxis *KPlotWidget::axis(Axis type)
 {
-    QHash<Axis, KPlotAxis *>::Iterator it = d->axes.find(type);
-    return it != d->axes.end() ? it.value() : nullptr;
+    return d->renderer.axis(KPlotRenderer::Axis(type));
 }
 
 const KPlotAxis *KPlotWidget::axis(Axis type) const
 {
-    QHash<Axis, KPlotAxis *>::ConstIterator it = d->axes.constFind(type);
-    return it != d->axes.constEnd() ? it.value() : nullptr;
+    return d->renderer.axis(KPlotRenderer::Axis(type));
 }
 
 QRect KPlotWidget::pixRect() const
 {
-    return d->pixRect;
+    return d->renderer.pixRect();
 }
 
 QList<KPlotPoint *> KPlotWidget::pointsUnderPoint(const QPoint &p) const
 {
-    QList<KPlotPoint *> pts;
-    for (const KPlotObject *po : std::as_const(d->objectList)) {
-        const auto pointsList = po->points();
-        for (KPlotPoint *pp : pointsList) {
-            if ((p - mapToWidget(pp->position()).toPoint()).manhattanLength() <= 4) {
-                pts << pp;
-            }
-        }
-    }
+    return d->renderer.pointsUnderPoint(p);
+}
 
-    return pts;
+KPlotPoint *KPlotWidget::nearestPoint(const QPoint &p) const
+{
+    return d->renderer.nearestPoint(p);
+}
+
+int KPlotWidget::pickRadius() const
+{
+    return d->renderer.pickRadius();
+}
+
+void KPlotWidget::setPickRadius(int radius)
+{
+    d->renderer.setPickRadius(radius);
 }
 
 bool KPlotWidget::event(QEvent *e)
 {
     if (e->type() == QEvent::ToolTip) {
-        if (d->showObjectToolTip) {
+        d->syncPlotObjects();
+        // Without labels there is nothing to show, and looking for the
+        // point would make uniformly sampled objects store their points
+        if (d->showObjectToolTip && d->hasLabels(d->rd->objectList)) {
             QHelpEvent *he = static_cast<QHelpEvent *>(e);
-            QList<KPlotPoint *> pts = pointsUnderPoint(he->pos() - QPoint(leftPadding(), topPadding()) - contentsRect().topLeft());
-            if (!pts.isEmpty()) {
-                QToolTip::showText(he->globalPos(), pts.front()->label(), this);
+            const KPlotPoint *point = nearestPoint(he->pos() - QPoint(leftPadding(), topPadding()) - contentsRect().topLeft());
+            if (point) {
+                QToolTip::showText(he->globalPos(), point->label(), this);
             }
         }
         e->accept();
@@ -431,600 +1258,798 @@ void KPlotWidget::resizeEvent(QResizeEvent *e)
     QFrame::resizeEvent(e);
     setPixRect();
     resetPlotMask();
+    d->interact();
 }
 
 void KPlotWidget::setPixRect()
 {
-    int newWidth = contentsRect().width() - leftPadding() - rightPadding();
-    int newHeight = contentsRect().height() - topPadding() - bottomPadding();
-    // PixRect starts at (0,0) because we will translate by leftPadding(), topPadding()
-    d->pixRect = QRect(0, 0, newWidth, newHeight);
+    d->renderer.setSize(contentsRect().size());
 }
 
 QPointF KPlotWidget::mapToWidget(const QPointF &p) const
 {
-    float px = d->pixRect.left() + d->pixRect.width() * (p.x() - d->dataRect.x()) / d->dataRect.width();
-    float py = d->pixRect.top() + d->pixRect.height() * (d->dataRect.y() + d->dataRect.height() - p.y()) / d->dataRect.height();
-    return QPointF(px, py);
+    return d->renderer.mapToPixRect(p);
 }
 
 void KPlotWidget::maskRect(const QRectF &rf, float fvalue)
 {
-    QRect r = rf.toRect().intersected(d->pixRect);
-    int value = int(fvalue);
-    QColor newColor;
-    for (int ix = r.left(); ix < r.right(); ++ix) {
-        for (int iy = r.top(); iy < r.bottom(); ++iy) {
-            newColor = QColor(d->plotMask.pixel(ix, iy));
-            newColor.setAlpha(200);
-            newColor.setRed(qMin(newColor.red() + value, 255));
-            d->plotMask.setPixel(ix, iy, newColor.rgba());
-        }
-    }
+    d->renderer.maskRect(rf, fvalue);
 }
 
 void KPlotWidget::maskAlongLine(const QPointF &p1, const QPointF &p2, float fvalue)
 {
-    if (!d->pixRect.contains(p1.toPoint()) && !d->pixRect.contains(p2.toPoint())) {
-        return;
+    d->renderer.maskAlongLine(p1, p2, fvalue);
+}
+
+void KPlotWidget::placeLabel(QPainter *painter, KPlotPoint *pp)
+{
+    d->renderer.placeLabel(painter, pp);
+}
+
+KPlotRenderer *KPlotWidget::renderer() const
+{
+    return &d->renderer;
+}
+
+void KPlotWidget::paintEvent(QPaintEvent *e)
+{
+    d->frameClock.start();
+    d->updatePending = false;
+    d->syncPlotObjects();
+    // The widget can be exposed during a batch of changes
+    d->rd->ensureTickMarks();
+
+    // let QFrame draw its default stuff (like the frame)
+    QFrame::paintEvent(e);
+    QPainter p;
+
+    // Draw aliased while the view is changing; everything below picks
+    // the setting up from the renderer
+    const bool antialias = d->rd->useAntialias;
+    if (d->interacting) {
+        d->rd->useAntialias = false;
     }
 
-    int value = int(fvalue);
+    p.begin(this);
+    p.setRenderHint(QPainter::Antialiasing, antialiasing());
+    p.fillRect(rect(), backgroundColor());
+    p.translate(leftPadding() + 0.5, topPadding() + 0.5);
 
-    // Determine slope and zeropoint of line
-    double m = (p2.y() - p1.y()) / (p2.x() - p1.x());
-    double y0 = p1.y() - m * p1.x();
-    QColor newColor;
+    setPixRect();
 
-    // Mask each pixel along the line joining p1 and p2
-    if (m > 1.0 || m < -1.0) { // step in y-direction
-        int y1 = int(p1.y());
-        int y2 = int(p2.y());
-        if (y1 > y2) {
-            y1 = int(p2.y());
-            y2 = int(p1.y());
+    if (!d->navigationImage.isNull()) {
+        // Zooming or panning; the plot objects are only rendered again
+        // once the view settles
+        d->drawNavigationImage(&p);
+    } else if (d->asyncRendering) {
+        // Show the latest frame, even if it is not up to date yet
+        d->requestFrame();
+        if (!d->asyncFrame.isNull()) {
+            p.drawImage(QPointF(-LAYERMARGIN - 0.5, -LAYERMARGIN - 0.5), d->asyncFrame);
         }
-
-        for (int y = y1; y <= y2; ++y) {
-            int x = int((y - y0) / m);
-            if (d->pixRect.contains(x, y)) {
-                newColor = QColor(d->plotMask.pixel(x, y));
-                newColor.setAlpha(100);
-                newColor.setRed(qMin(newColor.red() + value, 255));
-                d->plotMask.setPixel(x, y, newColor.rgba());
-            }
+    } else if (d->cacheObjectLayers || d->stripChart) {
+        d->updateObjectLayers();
+        // The layers already contain the half pixel offset
+        const QPointF layerOrigin(-LAYERMARGIN - 0.5, -LAYERMARGIN - 0.5);
+        for (KPlotObject *po : std::as_const(d->rd->objectList)) {
+            p.drawImage(layerOrigin, d->objectLayers.value(po).image);
         }
+    } else if (d->canRenderProgressively()) {
+        d->updateProgressiveFrame();
+        p.drawImage(QPointF(-LAYERMARGIN - 0.5, -LAYERMARGIN - 0.5), d->progressiveFrame);
+    } else if (d->parallelRendering && !d->hasLabels(d->rd->objectList)) {
+        QImage image = d->createLayerImage(d->rd->pixRect.size(), devicePixelRatioF());
+        d->renderTiled(d->rd->objectList, &image);
+        p.drawImage(QPointF(-LAYERMARGIN - 0.5, -LAYERMARGIN - 0.5), image);
+    } else {
+        d->renderer.drawPlotObjects(&p);
+    }
 
-    } else { // step in x-direction
-        int x1 = int(p1.x());
-        int x2 = int(p2.x());
-        if (x1 > x2) {
-            x1 = int(p2.x());
-            x2 = int(p1.x());
-        }
+    if (d->cacheAxes) {
+        d->updateAxesLayer();
+        p.drawImage(QPointF(-leftPadding() - 0.5, -topPadding() - 0.5), d->axesLayer);
+    } else {
+        drawAxes(&p);
+    }
 
-        for (int x = x1; x <= x2; ++x) {
-            int y = int(y0 + m * x);
-            if (d->pixRect.contains(x, y)) {
-                newColor = QColor(d->plotMask.pixel(x, y));
-                newColor.setAlpha(100);
-                newColor.setRed(qMin(newColor.red() + value, 255));
-                d->plotMask.setPixel(x, y, newColor.rgba());
-            }
-        }
+    if (d->dragMode == Private::RubberBandDrag && !d->rubberBand.isEmpty()) {
+        p.setRenderHint(QPainter::Antialiasing, false);
+        p.setPen(QPen(foregroundColor(), 0, Qt::DashLine));
+        p.setBrush(Qt::NoBrush);
+        p.drawRect(d->rubberBand);
     }
+
+    p.end();
+    d->rd->useAntialias = antialias;
 }
 
-// Determine optimal placement for a text label for point pp.  We want
-// the label to be near point pp, but we don't want it to overlap with
-// other labels or plot elements.  We will use a "downhill simplex"
-// algorithm to find a label position that minimizes the pixel values
-// in the plotMask image over the label's rect().  The sum of pixel
-// values in the label's rect is the "cost" of placing the label there.
-//
-// Because a downhill simplex follows the local gradient to find low
-// values, it can get stuck in local minima.  To mitigate this, we will
-// iteratively attempt each of the initial path offset directions (up,
-// down, right, left) in the order of increasing cost at each location.
-void KPlotWidget::placeLabel(QPainter *painter, KPlotPoint *pp)
+void KPlotWidget::mousePressEvent(QMouseEvent *e)
 {
-    int textFlags = Qt::TextSingleLine | Qt::AlignCenter;
-
-    QPointF pos = mapToWidget(pp->position());
-    if (!d->pixRect.contains(pos.toPoint())) {
+    const QPoint pos = d->plotPosition(e->position());
+    if (e->button() != Qt::LeftButton || d->dragMode != Private::NoDrag || !d->rd->pixRect.contains(pos)) {
+        QFrame::mousePressEvent(e);
         return;
     }
 
-    QFontMetricsF fm(painter->font(), painter->device());
-    QRectF bestRect = fm.boundingRect(QRectF(pos.x(), pos.y(), 1, 1), textFlags, pp->label());
-    float xStep = 0.5 * bestRect.width();
-    float yStep = 0.5 * bestRect.height();
-    float maxCost = 0.05 * bestRect.width() * bestRect.height();
-    float bestCost = d->rectCost(bestRect);
-
-    // We will travel along a path defined by the maximum decrease in
-    // the cost at each step.  If this path takes us to a local minimum
-    // whose cost exceeds maxCost, then we will restart at the
-    // beginning and select the next-best path.  The indices of
-    // already-tried paths are stored in the TriedPathIndex list.
-    //
-    // If we try all four first-step paths and still don't get below
-    // maxCost, then we'll adopt the local minimum position with the
-    // best cost (designated as bestBadCost).
-    int iter = 0;
-    QList<int> TriedPathIndex;
-    float bestBadCost = 10000;
-    QRectF bestBadRect;
-
-    // needed to halt iteration from inside the switch
-    bool flagStop = false;
-
-    while (bestCost > maxCost) {
-        // Displace the label up, down, left, right; determine which
-        // step provides the lowest cost
-        QRectF upRect = bestRect;
-        upRect.moveTop(upRect.top() + yStep);
-        float upCost = d->rectCost(upRect);
-        QRectF downRect = bestRect;
-        downRect.moveTop(downRect.top() - yStep);
-        float downCost = d->rectCost(downRect);
-        QRectF leftRect = bestRect;
-        leftRect.moveLeft(leftRect.left() - xStep);
-        float leftCost = d->rectCost(leftRect);
-        QRectF rightRect = bestRect;
-        rightRect.moveLeft(rightRect.left() + xStep);
-        float rightCost = d->rectCost(rightRect);
-
-        // which direction leads to the lowest cost?
-        QList<float> costList;
-        costList << upCost << downCost << leftCost << rightCost;
-        int imin = -1;
-        for (int i = 0; i < costList.size(); ++i) {
-            if (iter == 0 && TriedPathIndex.contains(i)) {
-                continue; // Skip this first-step path, we already tried it!
-            }
-
-            // If this first-step path doesn't improve the cost,
-            // skip this direction from now on
-            if (iter == 0 && costList[i] >= bestCost) {
-                TriedPathIndex.append(i);
-                continue;
-            }
+    if ((d->navigationModes & RubberBandZoom) && (!(d->navigationModes & DragPan) || (e->modifiers() & Qt::ShiftModifier))) {
+        d->dragMode = Private::RubberBandDrag;
+        d->rubberBand = QRect();
+    } else if (d->navigationModes & DragPan) {
+        d->dragMode = Private::PanDrag;
+    } else {
+        QFrame::mousePressEvent(e);
+        return;
+    }
+    // The rendering to move along is kept on the first step, so that
+    // clicks and rubber bands do not render the plot objects once more
+    d->dragStart = pos;
+    d->dragTransform = d->rd->transform;
+    e->accept();
+}
 
-            if (costList[i] < bestCost && (imin < 0 || costList[i] < costList[imin])) {
-                imin = i;
-            }
-        }
+void KPlotWidget::mouseMoveEvent(QMouseEvent *e)
+{
+    const QPoint pos = d->plotPosition(e->position());
+    switch (d->dragMode) {
+    case Private::NoDrag:
+        QFrame::mouseMoveEvent(e);
+        return;
 
-        // Make a note that we've tried the current first-step path
-        if (iter == 0 && imin >= 0) {
-            TriedPathIndex.append(imin);
-        }
+    case Private::PanDrag:
+        // Relative to the start of the drag, so that the steps do not
+        // accumulate rounding errors
+        d->navigationStep(d->dragTransform, QRectF(d->dragTransform.pixRect()).translated(d->dragStart - pos));
+        break;
 
-        // Adopt the step that produced the best cost
-        switch (imin) {
-        case 0: // up
-            bestRect.moveTop(upRect.top());
-            bestCost = upCost;
-            break;
-        case 1: // down
-            bestRect.moveTop(downRect.top());
-            bestCost = downCost;
-            break;
-        case 2: // left
-            bestRect.moveLeft(leftRect.left());
-            bestCost = leftCost;
-            break;
-        case 3: // right
-            bestRect.moveLeft(rightRect.left());
-            bestCost = rightCost;
-            break;
-        case -1: // no lower cost found!
-            // We hit a local minimum.  Keep the best of these as bestBadRect
-            if (bestCost < bestBadCost) {
-                bestBadCost = bestCost;
-                bestBadRect = bestRect;
-            }
+    case Private::RubberBandDrag:
+        d->rubberBand = QRect(d->dragStart, pos).normalized() & d->rd->pixRect;
+        d->scheduleUpdate();
+        break;
+    }
+    e->accept();
+}
 
-            // If all of the first-step paths have now been searched, we'll
-            // have to adopt the bestBadRect
-            if (TriedPathIndex.size() == 4) {
-                bestRect = bestBadRect;
-                flagStop = true; // halt iteration
-                break;
-            }
+void KPlotWidget::mouseReleaseEvent(QMouseEvent *e)
+{
+    if (d->dragMode == Private::NoDrag || e->button() != Qt::LeftButton) {
+        QFrame::mouseReleaseEvent(e);
+        return;
+    }
 
-            // If we haven't yet tried all of the first-step paths, start over
-            if (TriedPathIndex.size() < 4) {
-                iter = -1; // anticipating the ++iter below
-                bestRect = fm.boundingRect(QRectF(pos.x(), pos.y(), 1, 1), textFlags, pp->label());
-                bestCost = d->rectCost(bestRect);
-            }
-            break;
+    if (d->dragMode == Private::RubberBandDrag) {
+        const QRectF band = QRectF(d->dragStart, d->plotPosition(e->position())).normalized() & QRectF(d->rd->pixRect);
+        d->dragMode = Private::NoDrag;
+        // A single jump, rendered right away
+        d->navigationTimer.stop();
+        d->navigationImage = QImage();
+        // Smaller rectangles are more likely clicks than zooms
+        if (band.width() >= 3 && band.height() >= 3) {
+            d->navigateTo(d->rd->transform, band);
         }
-
-        // Halt iteration, because we've tried all directions and
-        // haven't gotten below maxCost (we'll adopt the best
-        // local minimum found)
-        if (flagStop) {
-            break;
+        d->scheduleUpdate();
+    } else {
+        // The view is rendered again once the navigation delay has passed,
+        // or right away if it did not move
+        d->dragMode = Private::NoDrag;
+        if (!d->navigationTimer.isActive() && !d->navigationImage.isNull()) {
+            d->navigationImage = QImage();
+            d->scheduleUpdate();
         }
+    }
+    e->accept();
+}
 
-        ++iter;
+void KPlotWidget::wheelEvent(QWheelEvent *e)
+{
+    const QPoint pos = d->plotPosition(e->position());
+    const double steps = e->angleDelta().y() / 120.0;
+    if (!(d->navigationModes & WheelZoom) || steps == 0.0 || !d->rd->pixRect.contains(pos)) {
+        QFrame::wheelEvent(e);
+        return;
     }
 
-    painter->drawText(bestRect, textFlags, pp->label());
+    // Each step forward zooms in by 20%, keeping the point under the cursor
+    const double f = pow(1.2, -steps);
+    const QRect r = d->rd->pixRect;
+    d->navigationStep(d->rd->transform,
+                      QRectF(r.left() + (pos.x() - r.left()) * (1.0 - f), r.top() + (pos.y() - r.top()) * (1.0 - f), r.width() * f, r.height() * f));
+    e->accept();
+}
 
-    // Is a line needed to connect the label to the point?
-    float deltax = pos.x() - bestRect.center().x();
-    float deltay = pos.y() - bestRect.center().y();
-    float rbest = sqrt(deltax * deltax + deltay * deltay);
-    if (rbest > 20.0) {
-        // Draw a rectangle around the label
-        painter->setBrush(QBrush());
-        // QPen pen = painter->pen();
-        // pen.setStyle( Qt::DotLine );
-        // painter->setPen( pen );
-        painter->drawRoundedRect(bestRect, 25, 25, Qt::RelativeSize);
+void KPlotWidget::Private::updateObjectLayers()
+{
+    // Forget the layers of objects which were removed
+    for (auto it = objectLayers.begin(); it != objectLayers.end();) {
+        if (rd->objectList.contains(it.key())) {
+            ++it;
+        } else {
+            it = objectLayers.erase(it);
+        }
+    }
 
-        // Now connect the label to the point with a line.
-        // The line is drawn from the center of the near edge of the rectangle
-        float xline = bestRect.center().x();
-        if (bestRect.left() > pos.x()) {
-            xline = bestRect.left();
+    const qreal dpr = q->devicePixelRatioF();
+    for (KPlotObject *po : std::as_const(rd->objectList)) {
+        ObjectLayer &layer = objectLayers[po];
+        const bool antialiasValid = layerAntialiasValid(layer.antialias);
+        if (!layer.image.isNull() && layer.revision == po->d->revision && layer.transform == rd->transform && antialiasValid
+            && layer.devicePixelRatio == dpr) {
+            continue;
         }
-        if (bestRect.right() < pos.x()) {
-            xline = bestRect.right();
+        // Layers of objects which only had points appended can be
+        // extended; in strip chart mode also when the x limits moved.
+        if ((stripChart || layer.transform == rd->transform) && antialiasValid && layer.devicePixelRatio == dpr && scrollObjectLayer(po, layer)) {
+            // Drawn again in full once antialiased, if the new parts
+            // were not
+            layer.antialias = layer.antialias && rd->useAntialias;
+            continue;
         }
 
-        float yline = bestRect.center().y();
-        if (bestRect.top() > pos.y()) {
-            yline = bestRect.top();
-        }
-        if (bestRect.bottom() < pos.y()) {
-            yline = bestRect.bottom();
+        layer.image = createLayerImage(rd->pixRect.size(), dpr);
+        if (parallelRendering && po->d->labelCount == 0) {
+            renderTiled({po}, &layer.image);
+        } else {
+            QPainter p(&layer.image);
+            p.setRenderHint(QPainter::Antialiasing, rd->useAntialias);
+            p.setFont(q->font());
+            p.translate(LAYERMARGIN + 0.5, LAYERMARGIN + 0.5);
+            p.setClipRect(rd->pixRect);
+
+            // Each layer gets its own label mask
+            renderer.resetPlotMask();
+            po->draw(&p, &renderer);
         }
 
-        painter->drawLine(QPointF(xline, yline), pos);
+        layer.revision = po->d->revision;
+        layer.resetRevision = po->d->resetRevision;
+        layer.pointCount = po->d->count();
+        layer.transform = rd->transform;
+        layer.residual = 0.0;
+        layer.antialias = rd->useAntialias;
+        layer.devicePixelRatio = dpr;
     }
-
-    // Mask the label's rectangle so other labels won't overlap it.
-    maskRect(bestRect);
 }
 
-float KPlotWidget::Private::rectCost(const QRectF &r) const
+KPlotWidget::Private::AxesState KPlotWidget::Private::axesState() const
 {
-    if (!plotMask.rect().contains(r.toRect())) {
-        return 10000.;
+    AxesState state;
+    state.size = q->size();
+    state.origin = QPoint(q->leftPadding(), q->topPadding());
+    state.transform = rd->transform;
+    state.secondDataRect = rd->secondDataRect;
+    state.showGrid = rd->showGrid;
+    state.antialias = rd->useAntialias;
+    state.background = rd->cBackground;
+    state.foreground = rd->cForeground;
+    state.grid = rd->cGrid;
+    state.font = q->font();
+    state.devicePixelRatio = q->devicePixelRatioF();
+
+    const Axis types[4] = {LeftAxis, BottomAxis, RightAxis, TopAxis};
+    for (int i = 0; i < 4; ++i) {
+        const KPlotAxis *a = q->axis(types[i]);
+        AxisState &as = state.axes[i];
+        as.visible = a->isVisible();
+        as.showTickLabels = a->areTickLabelsShown();
+        as.labelFormat = a->tickLabelFormat();
+        as.labelFieldWidth = a->tickLabelWidth();
+        as.labelPrecision = a->tickLabelPrecision();
+        as.label = a->label();
+        as.majorTickMarks = a->majorTickMarks();
+        as.minorTickMarks = a->minorTickMarks();
     }
+    return state;
+}
 
-    // Compute sum of mask values in the rect r
-    QImage subMask = plotMask.copy(r.toRect());
-    int cost = 0;
-    for (int ix = 0; ix < subMask.width(); ++ix) {
-        for (int iy = 0; iy < subMask.height(); ++iy) {
-            cost += QColor(subMask.pixel(ix, iy)).red();
+void KPlotWidget::Private::updateAxesLayer()
+{
+    AxesState state = axesState();
+    if (!axesLayer.isNull() && layerAntialiasValid(axesLayerState.antialias)) {
+        state.antialias = axesLayerState.antialias;
+        if (state == axesLayerState) {
+            return;
         }
+        state.antialias = rd->useAntialias;
     }
 
-    return float(cost);
+    // The layer covers the whole widget, as the tick labels and axis
+    // labels are drawn in the paddings around the plot area.  The paddings
+    // are filled with the background, so that text is rendered onto it as
+    // on the widget, with subpixel antialiasing; only the plot area, where
+    // the plot objects show through, is transparent.
+    axesLayer = QImage(state.size * state.devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    axesLayer.setDevicePixelRatio(state.devicePixelRatio);
+    axesLayer.fill(state.background);
+
+    QPainter p(&axesLayer);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    p.fillRect(QRect(state.origin, state.transform.pixRect().size()), Qt::transparent);
+    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    p.setRenderHint(QPainter::Antialiasing, rd->useAntialias);
+    p.setFont(q->font());
+    p.translate(state.origin.x() + 0.5, state.origin.y() + 0.5);
+    q->drawAxes(&p);
+
+    axesLayerState = std::move(state);
 }
 
-void KPlotWidget::paintEvent(QPaintEvent *e)
+KPlotWidget::Private::FrameState KPlotWidget::Private::frameState() const
 {
-    // let QFrame draw its default stuff (like the frame)
-    QFrame::paintEvent(e);
-    QPainter p;
+    FrameState state;
+    state.transform = rd->transform;
+    state.antialias = rd->useAntialias;
+    state.devicePixelRatio = q->devicePixelRatioF();
+    state.font = q->font();
+    state.revisions.reserve(rd->objectList.size());
+    for (const KPlotObject *po : std::as_const(rd->objectList)) {
+        state.revisions.append(po->d->revision);
+    }
+    return state;
+}
 
-    p.begin(this);
-    p.setRenderHint(QPainter::Antialiasing, d->useAntialias);
-    p.fillRect(rect(), backgroundColor());
-    p.translate(leftPadding() + 0.5, topPadding() + 0.5);
+void KPlotWidget::Private::requestFrame()
+{
+    if (frameInFlight) {
+        // Presenting the frame schedules an update, which requests the
+        // next one for the state of the objects then
+        return;
+    }
+    FrameState state = frameState();
+    if (frameRequested && state == requestedFrame) {
+        return;
+    }
 
-    setPixRect();
-    p.setClipRect(d->pixRect);
-    p.setClipping(true);
+    // Everything the worker needs is copied, so that the objects and the
+    // widget can change while it renders
+    struct Job {
+        std::vector<std::unique_ptr<KPlotObject::Private>> objects;
+        FrameState state;
+        QImage image;
+        quint64 generation = 0;
+    };
+    auto job = std::make_shared<Job>();
+    job->objects.reserve(rd->objectList.size());
+    for (const KPlotObject *po : std::as_const(rd->objectList)) {
+        job->objects.push_back(po->d->snapshot());
+    }
+    job->state = state;
+    job->generation = asyncState->generation;
+
+    requestedFrame = std::move(state);
+    frameRequested = true;
+    frameInFlight = true;
+
+    std::shared_ptr<AsyncState> shared = asyncState;
+    Private *self = this;
+    QThreadPool::globalInstance()->start([shared, job, self] {
+        const KPlotTransform &t = job->state.transform;
+        const QRect plotRect = t.pixRect();
+        KPlotMask mask;
+        mask.reset(plotRect.size());
+        job->image = createLayerImage(plotRect.size(), job->state.devicePixelRatio);
+        {
+            QPainter p(&job->image);
+            p.setRenderHint(QPainter::Antialiasing, job->state.antialias);
+            p.setFont(job->state.font);
+            p.translate(LAYERMARGIN + 0.5, LAYERMARGIN + 0.5);
+            p.setClipRect(plotRect);
+            for (const auto &od : job->objects) {
+                if (shared->generation != job->generation) {
+                    return; // dropped
+                }
+                od->draw(&p, &mask, t, t.dataRect().left(), t.dataRect().right());
+            }
+        }
 
-    resetPlotMask();
+        QMutexLocker locker(&shared->mutex);
+        if (!shared->widget || shared->generation != job->generation) {
+            return;
+        }
+        // The widget cannot be destroyed while the mutex is held, and the
+        // call is dropped if it is destroyed before it gets delivered
+        QMetaObject::invokeMethod(
+            shared->widget,
+            [self, job] {
+                // The frame may have been dropped after it was sent
+                if (job->generation != self->asyncState->generation) {
+                    return;
+                }
+                self->frameInFlight = false;
+                self->asyncFrame = job->image;
+                self->scheduleUpdate();
+            },
+            Qt::QueuedConnection);
+    });
+}
 
-    for (KPlotObject *po : std::as_const(d->objectList)) {
-        po->draw(&p, this);
-    }
+QImage KPlotWidget::Private::createLayerImage(const QSize &plotSize, qreal dpr)
+{
+    const QSize layerSize = plotSize + QSize(2 * LAYERMARGIN, 2 * LAYERMARGIN);
+    QImage image(layerSize * dpr, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+    image.fill(Qt::transparent);
+    return image;
+}
 
-    // DEBUG: Draw the plot mask
-    //    p.drawImage( 0, 0, d->plotMask );
+bool KPlotWidget::Private::hasLabels(const QList<KPlotObject *> &objects) const
+{
+    return std::any_of(objects.cbegin(), objects.cend(), [](const KPlotObject *po) {
+        return po->d->labelCount > 0;
+    });
+}
 
-    p.setClipping(false);
-    drawAxes(&p);
+bool KPlotWidget::Private::canRenderProgressively() const
+{
+    if (!progressiveRendering || hasLabels(rd->objectList)) {
+        return false;
+    }
+    return std::all_of(rd->objectList.cbegin(), rd->objectList.cend(), [](const KPlotObject *po) {
+        return po->d->sortedX;
+    });
+}
 
-    p.end();
+void KPlotWidget::Private::syncPlotObjects()
+{
+    for (KPlotObject *po : std::as_const(rd->objectList)) {
+        po->d->syncColumns();
+    }
 }
 
-void KPlotWidget::drawAxes(QPainter *p)
+void KPlotWidget::Private::renderTiled(const QList<KPlotObject *> &objects, QImage *image)
 {
-    if (d->showGrid) {
-        p->setPen(gridColor());
+    const KPlotTransform t = rd->transform;
+    const qreal dpr = image->devicePixelRatio();
+    const double left = -LAYERMARGIN - 0.5;
+    const double right = image->width() / dpr + left;
+
+    // Map all points that the tiles can draw up front, as the tiles only
+    // read the objects
+    for (KPlotObject *po : objects) {
+        KPlotObject::Private *od = po->d.get();
+        const double reach = od->reach();
+        const double x1 = t.unmapX(left - reach);
+        const double x2 = t.unmapX(right + reach);
+        qsizetype first;
+        qsizetype last;
+        od->visibleRange(qMin(x1, x2), qMax(x1, x2), &first, &last);
+        od->mapPoints(t, first, last);
+        od->updateViewCount(t);
+    }
 
-        // Grid lines are placed at locations of primary axes' major tickmarks
-        // vertical grid lines
-        const QList<double> majMarks = axis(BottomAxis)->majorTickMarks();
-        for (const double xx : majMarks) {
-            double px = d->pixRect.width() * (xx - d->dataRect.x()) / d->dataRect.width();
-            p->drawLine(QPointF(px, 0.0), QPointF(px, double(d->pixRect.height())));
-        }
-        // horizontal grid lines
-        const QList<double> leftTickMarks = axis(LeftAxis)->majorTickMarks();
-        for (const double yy : leftTickMarks) {
-            double py = d->pixRect.height() * (1.0 - (yy - d->dataRect.y()) / d->dataRect.height());
-            p->drawLine(QPointF(0.0, py), QPointF(double(d->pixRect.width()), py));
+    // Runs of sorted objects are tiled, and the others drawn in between,
+    // so that the objects still overlap in order
+    QList<KPlotObject *> run;
+    for (KPlotObject *po : objects) {
+        const KPlotObject::Private *od = po->d.get();
+        if (od->sortedX) {
+            run.append(po);
+            continue;
         }
+        renderTiles(run, image);
+        run.clear();
+
+        QPainter p(image);
+        p.setRenderHint(QPainter::Antialiasing, rd->useAntialias);
+        p.translate(LAYERMARGIN + 0.5, LAYERMARGIN + 0.5);
+        p.setClipRect(rd->pixRect);
+        p.setFont(q->font());
+        const double reach = od->reach();
+        const double x1 = t.unmapX(left - reach);
+        const double x2 = t.unmapX(right + reach);
+        od->paint(&p, nullptr, t, qMin(x1, x2), qMax(x1, x2));
     }
+    renderTiles(run, image);
+}
 
-    p->setPen(foregroundColor());
-    p->setBrush(Qt::NoBrush);
-
-    // set small font for tick labels
-    QFont f = p->font();
-    int s = f.pointSize();
-    f.setPointSize(s - 2);
-    p->setFont(f);
-
-    /* BottomAxis */
-    KPlotAxis *a = axis(BottomAxis);
-    if (a->isVisible()) {
-        // Draw axis line
-        p->drawLine(0, d->pixRect.height(), d->pixRect.width(), d->pixRect.height());
-
-        // Draw major tickmarks
-        const QList<double> majMarks = a->majorTickMarks();
-        for (const double xx : majMarks) {
-            double px = d->pixRect.width() * (xx - d->dataRect.x()) / d->dataRect.width();
-            if (px > 0 && px < d->pixRect.width()) {
-                p->drawLine(QPointF(px, double(d->pixRect.height() - TICKOFFSET)), //
-                            QPointF(px, double(d->pixRect.height() - BIGTICKSIZE - TICKOFFSET)));
-
-                // Draw ticklabel
-                if (a->areTickLabelsShown()) {
-                    QRect r(int(px) - BIGTICKSIZE, d->pixRect.height() + BIGTICKSIZE, 2 * BIGTICKSIZE, BIGTICKSIZE);
-                    p->drawText(r, Qt::AlignCenter | Qt::TextDontClip, a->tickLabel(xx));
-                }
-            }
+void KPlotWidget::Private::renderTiles(const QList<KPlotObject *> &objects, QImage *image)
+{
+    if (objects.isEmpty()) {
+        return;
+    }
+    const KPlotTransform t = rd->transform;
+    const qreal dpr = image->devicePixelRatio();
+    const double left = -LAYERMARGIN - 0.5;
+
+    // Split the columns into a few tiles per thread, for load balancing
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int tileCount = qBound(1, image->width() / 32, 2 * pool->maxThreadCount());
+    const int width = image->width();
+    const int height = image->height();
+    // Taken here, as QImage::scanLine() is not safe to call from several threads
+    uchar *const bits = image->bits();
+    const qsizetype bytesPerLine = image->bytesPerLine();
+    const bool antialias = rd->useAntialias;
+    const QRect plotRect = rd->pixRect;
+    // For the Letter markers
+    const QFont font = q->font();
+
+    auto renderTile = [=](int tile) {
+        const int c1 = width * tile / tileCount;
+        const int c2 = width * (tile + 1) / tileCount;
+        // Start from what the columns hold, to draw over earlier objects
+        QImage strip(c2 - c1, height, QImage::Format_ARGB32_Premultiplied);
+        strip.setDevicePixelRatio(dpr);
+        for (int y = 0; y < height; ++y) {
+            memcpy(strip.scanLine(y), bits + y * bytesPerLine + c1 * sizeof(QRgb), (c2 - c1) * sizeof(QRgb));
         }
-
-        // Draw minor tickmarks
-        const QList<double> minTickMarks = a->minorTickMarks();
-        for (const double xx : minTickMarks) {
-            double px = d->pixRect.width() * (xx - d->dataRect.x()) / d->dataRect.width();
-            if (px > 0 && px < d->pixRect.width()) {
-                p->drawLine(QPointF(px, double(d->pixRect.height() - TICKOFFSET)), //
-                            QPointF(px, double(d->pixRect.height() - SMALLTICKSIZE - TICKOFFSET)));
+        {
+            QPainter p(&strip);
+            p.setRenderHint(QPainter::Antialiasing, antialias);
+            p.translate(LAYERMARGIN + 0.5 - c1 / dpr, LAYERMARGIN + 0.5);
+            p.setClipRect(plotRect);
+            p.setFont(font);
+            for (const KPlotObject *po : objects) {
+                const KPlotObject::Private *od = po->d.get();
+                // Points within reach of the tile can draw into it
+                const double reach = od->reach();
+                const double x1 = t.unmapX(c1 / dpr + left - reach);
+                const double x2 = t.unmapX(c2 / dpr + left + reach);
+                od->paint(&p, nullptr, t, qMin(x1, x2), qMax(x1, x2));
             }
         }
-
-        // Draw BottomAxis Label
-        if (!a->label().isEmpty()) {
-            QRect r(0, d->pixRect.height() + 2 * YPADDING, d->pixRect.width(), YPADDING);
-            p->drawText(r, Qt::AlignCenter, a->label());
+        for (int y = 0; y < height; ++y) {
+            memcpy(bits + y * bytesPerLine + c1 * sizeof(QRgb), strip.constScanLine(y), (c2 - c1) * sizeof(QRgb));
         }
-    } // End of BottomAxis
-
-    /* LeftAxis */
-    a = axis(LeftAxis);
-    if (a->isVisible()) {
-        // Draw axis line
-        p->drawLine(0, 0, 0, d->pixRect.height());
-
-        // Draw major tickmarks
-        const QList<double> majMarks = a->majorTickMarks();
-        for (const double yy : majMarks) {
-            double py = d->pixRect.height() * (1.0 - (yy - d->dataRect.y()) / d->dataRect.height());
-            if (py > 0 && py < d->pixRect.height()) {
-                p->drawLine(QPointF(TICKOFFSET, py), QPointF(double(TICKOFFSET + BIGTICKSIZE), py));
-
-                // Draw ticklabel
-                if (a->areTickLabelsShown()) {
-                    QRect r(-2 * BIGTICKSIZE - SMALLTICKSIZE, int(py) - SMALLTICKSIZE, 2 * BIGTICKSIZE, 2 * SMALLTICKSIZE);
-                    p->drawText(r, Qt::AlignRight | Qt::AlignVCenter | Qt::TextDontClip, a->tickLabel(yy));
-                }
-            }
+    };
+
+    // The tiles write to separate columns of image, so they can be copied
+    // in without locking.  The last tile is rendered on this thread.
+    QSemaphore done;
+    for (int tile = 0; tile < tileCount - 1; ++tile) {
+        pool->start([&, tile] {
+            renderTile(tile);
+            done.release();
+        });
+    }
+    renderTile(tileCount - 1);
+    done.acquire(tileCount - 1);
+}
+
+void KPlotWidget::Private::renderStrip(QImage *image, int c1, int c2)
+{
+    const qreal dpr = image->devicePixelRatio();
+    QImage strip(c2 - c1, image->height(), QImage::Format_ARGB32_Premultiplied);
+    strip.setDevicePixelRatio(dpr);
+    strip.fill(Qt::transparent);
+    {
+        QPainter p(&strip);
+        p.setRenderHint(QPainter::Antialiasing, rd->useAntialias);
+        p.translate(LAYERMARGIN + 0.5 - c1 / dpr, LAYERMARGIN + 0.5);
+        p.setClipRect(rd->pixRect);
+        p.setFont(q->font());
+
+        const KPlotTransform &t = rd->transform;
+        const double left = -LAYERMARGIN - 0.5;
+        for (KPlotObject *po : std::as_const(rd->objectList)) {
+            KPlotObject::Private *od = po->d.get();
+            // Points within reach of the strip can draw into it
+            const double reach = od->reach();
+            const double x1 = t.unmapX(c1 / dpr + left - reach);
+            const double x2 = t.unmapX(c2 / dpr + left + reach);
+            od->draw(&p, nullptr, t, qMin(x1, x2), qMax(x1, x2));
         }
+    }
+    for (int y = 0; y < strip.height(); ++y) {
+        memcpy(image->scanLine(y) + c1 * sizeof(QRgb), strip.constScanLine(y), (c2 - c1) * sizeof(QRgb));
+    }
+}
 
-        // Draw minor tickmarks
-        const QList<double> minTickMarks = a->minorTickMarks();
-        for (const double yy : minTickMarks) {
-            double py = d->pixRect.height() * (1.0 - (yy - d->dataRect.y()) / d->dataRect.height());
-            if (py > 0 && py < d->pixRect.height()) {
-                p->drawLine(QPointF(TICKOFFSET, py), QPointF(double(TICKOFFSET + SMALLTICKSIZE), py));
+void KPlotWidget::Private::updateProgressiveFrame()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    FrameState state = frameState();
+    if (progressiveFrame.isNull() || !(state == progressiveState)) {
+        // Start over with a preview, which only draws a few points per
+        // pixel column of each object
+        progressiveFrame = createLayerImage(rd->pixRect.size(), state.devicePixelRatio);
+        {
+            QPainter p(&progressiveFrame);
+            p.setRenderHint(QPainter::Antialiasing, rd->useAntialias);
+            p.translate(LAYERMARGIN + 0.5, LAYERMARGIN + 0.5);
+            p.setClipRect(rd->pixRect);
+
+            const KPlotTransform &t = rd->transform;
+            for (KPlotObject *po : std::as_const(rd->objectList)) {
+                std::unique_ptr<KPlotObject::Private> preview = po->d->decimated(t);
+                KPlotObject::Private *od = preview ? preview.get() : po->d.get();
+                od->draw(&p, nullptr, t, t.dataRect().left(), t.dataRect().right());
             }
         }
+        progressiveState = std::move(state);
+        progressiveColumn = 0;
+    }
 
-        // Draw LeftAxis Label.  We need to draw the text sideways.
-        if (!a->label().isEmpty()) {
-            // store current painter translation/rotation state
-            p->save();
-
-            // translate coord sys to left corner of axis label rectangle, then rotate 90 degrees.
-            p->translate(-3 * XPADDING, d->pixRect.height());
-            p->rotate(-90.0);
+    const int width = progressiveFrame.width();
+    if (progressiveColumn >= width) {
+        return;
+    }
 
-            QRect r(0, 0, d->pixRect.height(), XPADDING);
-            p->drawText(r, Qt::AlignCenter, a->label()); // draw the label, now that we are sideways
+    // Replace the preview strip by strip; at least one strip is rendered
+    // per paint, so that the frame is completed even with a tight budget
+    do {
+        const int c2 = qMin(progressiveColumn + PROGRESSIVESTRIP, width);
+        renderStrip(&progressiveFrame, progressiveColumn, c2);
+        progressiveColumn = c2;
+    } while (progressiveColumn < width && timer.elapsed() < frameBudget);
+
+    if (progressiveColumn < width) {
+        // Go on after the events that came in meanwhile were handled
+        QMetaObject::invokeMethod(
+            q,
+            [this] {
+                scheduleUpdate();
+            },
+            Qt::QueuedConnection);
+    } else {
+        // The frame is shown once this paint is done
+        QMetaObject::invokeMethod(q, &KPlotWidget::frameCompleted, Qt::QueuedConnection);
+    }
+}
 
-            p->restore(); // restore translation/rotation state
+// Move the contents of image by dx pixels to the right (or left, if dx is
+// negative), leaving the exposed columns transparent
+static void scrollImage(QImage *image, int dx)
+{
+    const int w = image->width();
+    for (int y = 0; y < image->height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(image->scanLine(y));
+        if (dx > 0) {
+            memmove(line + dx, line, (w - dx) * sizeof(QRgb));
+            std::fill(line, line + dx, 0);
+        } else if (dx < 0) {
+            memmove(line, line - dx, (w + dx) * sizeof(QRgb));
+            std::fill(line + w + dx, line + w, 0);
         }
-    } // End of LeftAxis
+    }
+}
 
-    // Prepare for top and right axes; we may need the secondary data rect
-    double x0 = d->dataRect.x();
-    double y0 = d->dataRect.y();
-    double dw = d->dataRect.width();
-    double dh = d->dataRect.height();
-    if (secondaryDataRect().isValid()) {
-        x0 = secondaryDataRect().x();
-        y0 = secondaryDataRect().y();
-        dw = secondaryDataRect().width();
-        dh = secondaryDataRect().height();
+bool KPlotWidget::Private::scrollObjectLayer(KPlotObject *po, ObjectLayer &layer)
+{
+    KPlotObject::Private *od = po->d.get();
+    double dx;
+    if (layer.image.isNull() || layer.resetRevision != od->resetRevision || !rd->transform.isShiftedX(layer.transform, &dx)) {
+        return false;
+    }
+    // Labels are placed around the other points, and bars get their
+    // width from the next point, so new points can change old parts
+    if (od->labelCount > 0 || (od->type & KPlotObject::Bars)) {
+        return false;
     }
 
-    /* TopAxis */
-    a = axis(TopAxis);
-    if (a->isVisible()) {
-        // Draw axis line
-        p->drawLine(0, 0, d->pixRect.width(), 0);
-
-        // Draw major tickmarks
-        const QList<double> majMarks = a->majorTickMarks();
-        for (const double xx : majMarks) {
-            double px = d->pixRect.width() * (xx - x0) / dw;
-            if (px > 0 && px < d->pixRect.width()) {
-                p->drawLine(QPointF(px, TICKOFFSET), QPointF(px, double(BIGTICKSIZE + TICKOFFSET)));
-
-                // Draw ticklabel
-                if (a->areTickLabelsShown()) {
-                    QRect r(int(px) - BIGTICKSIZE, (int)-1.5 * BIGTICKSIZE, 2 * BIGTICKSIZE, BIGTICKSIZE);
-                    p->drawText(r, Qt::AlignCenter | Qt::TextDontClip, a->tickLabel(xx));
-                }
-            }
+    // Only scroll by whole pixels; the layer is then drawn for a
+    // transform that is less than half a pixel off the exact one, and
+    // the difference is made up by later scrolls
+    const qreal dpr = layer.devicePixelRatio;
+    dx -= layer.residual;
+    // Half a pixel off is kept, rather than moving the layer back and forth
+    const int shift = qAbs(dx * dpr) <= 0.5 ? 0 : qRound(dx * dpr);
+    if (qAbs(shift) >= layer.image.width()) {
+        return false;
+    }
+    const double residual = shift / dpr - dx;
+    const KPlotTransform t = rd->transform.translatedX(residual);
+
+    // Distance around a point or line end that its drawing can cover
+    const double reach = od->reach();
+    // The strip of the plot that has to be drawn again
+    const double left = -LAYERMARGIN - 1.0;
+    const double right = rd->pixRect.width() + LAYERMARGIN + 1.0;
+    double x1 = right;
+    double x2 = left;
+    if (shift < 0) {
+        x1 = rd->pixRect.width() + shift / dpr - reach;
+        x2 = right;
+    } else if (shift > 0) {
+        x1 = left;
+        x2 = shift / dpr + reach;
+    }
+    // The new points, and the line joining them to the previous ones
+    const qsizetype n = od->count();
+    for (qsizetype i = qMax(layer.pointCount - 1, qsizetype(0)); i < n; ++i) {
+        const double px = t.mapX(od->xAt(i));
+        if (qIsFinite(px)) {
+            x1 = qMin(x1, px - reach);
+            x2 = qMax(x2, px + reach);
         }
-
-        // Draw minor tickmarks
-        const QList<double> minMarks = a->minorTickMarks();
-        for (const double xx : minMarks) {
-            double px = d->pixRect.width() * (xx - x0) / dw;
-            if (px > 0 && px < d->pixRect.width()) {
-                p->drawLine(QPointF(px, TICKOFFSET), QPointF(px, double(SMALLTICKSIZE + TICKOFFSET)));
-            }
+    }
+    x1 = qMax(x1, left);
+    x2 = qMin(x2, right);
+
+    scrollImage(&layer.image, shift);
+
+    // Draw the part of the plot in [from, to] into an image of its own,
+    // which then replaces these columns of the layer
+    auto redraw = [&](double from, double to) {
+        const int c1 = qBound(0, int(floor((from + LAYERMARGIN + 0.5) * dpr)), layer.image.width());
+        const int c2 = qBound(0, int(ceil((to + LAYERMARGIN + 0.5) * dpr)), layer.image.width());
+        if (c1 >= c2) {
+            return;
         }
 
-        // Draw TopAxis Label
-        if (!a->label().isEmpty()) {
-            QRect r(0, 0 - 3 * YPADDING, d->pixRect.width(), YPADDING);
-            p->drawText(r, Qt::AlignCenter, a->label());
+        QImage strip(c2 - c1, layer.image.height(), QImage::Format_ARGB32_Premultiplied);
+        strip.setDevicePixelRatio(dpr);
+        strip.fill(Qt::transparent);
+        {
+            QPainter p(&strip);
+            p.setRenderHint(QPainter::Antialiasing, rd->useAntialias);
+            p.setFont(q->font());
+            p.translate(LAYERMARGIN + 0.5 - c1 / dpr, LAYERMARGIN + 0.5);
+            p.setClipRect(rd->pixRect);
+
+            // Points within reach of the strip can draw into it
+            const double dx1 = t.unmapX(from - reach);
+            const double dx2 = t.unmapX(to + reach);
+            od->draw(&p, &rd->mask, t, qMin(dx1, dx2), qMax(dx1, dx2));
         }
-    } // End of TopAxis
-
-    /* RightAxis */
-    a = axis(RightAxis);
-    if (a->isVisible()) {
-        // Draw axis line
-        p->drawLine(d->pixRect.width(), 0, d->pixRect.width(), d->pixRect.height());
-
-        // Draw major tickmarks
-        const QList<double> majMarks = a->majorTickMarks();
-        for (const double yy : majMarks) {
-            double py = d->pixRect.height() * (1.0 - (yy - y0) / dh);
-            if (py > 0 && py < d->pixRect.height()) {
-                p->drawLine(QPointF(double(d->pixRect.width() - TICKOFFSET), py), //
-                            QPointF(double(d->pixRect.width() - TICKOFFSET - BIGTICKSIZE), py));
-
-                // Draw ticklabel
-                if (a->areTickLabelsShown()) {
-                    QRect r(d->pixRect.width() + SMALLTICKSIZE, int(py) - SMALLTICKSIZE, 2 * BIGTICKSIZE, 2 * SMALLTICKSIZE);
-                    p->drawText(r, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextDontClip, a->tickLabel(yy));
-                }
-            }
+        for (int y = 0; y < strip.height(); ++y) {
+            memcpy(layer.image.scanLine(y) + c1 * sizeof(QRgb), strip.constScanLine(y), (c2 - c1) * sizeof(QRgb));
         }
+    };
 
-        // Draw minor tickmarks
-        const QList<double> minMarks = a->minorTickMarks();
-        for (const double yy : minMarks) {
-            double py = d->pixRect.height() * (1.0 - (yy - y0) / dh);
-            if (py > 0 && py < d->pixRect.height()) {
-                p->drawLine(QPointF(double(d->pixRect.width() - 0.0), py), QPointF(double(d->pixRect.width() - 0.0 - SMALLTICKSIZE), py));
-            }
-        }
-
-        // Draw RightAxis Label.  We need to draw the text sideways.
-        if (!a->label().isEmpty()) {
-            // store current painter translation/rotation state
-            p->save();
-
-            // translate coord sys to left corner of axis label rectangle, then rotate 90 degrees.
-            p->translate(d->pixRect.width() + 2 * XPADDING, d->pixRect.height());
-            p->rotate(-90.0);
+    // What was scrolled across the edge of the plot is cut off there
+    if (shift < 0) {
+        redraw(left, 1.0);
+    } else if (shift > 0) {
+        redraw(rd->pixRect.width() - 1.0, right);
+    }
+    redraw(x1, x2);
 
-            QRect r(0, 0, d->pixRect.height(), XPADDING);
-            p->drawText(r, Qt::AlignCenter, a->label()); // draw the label, now that we are sideways
+    layer.revision = od->revision;
+    layer.pointCount = n;
+    layer.transform = rd->transform;
+    layer.residual = residual;
+    return true;
+}
 
-            p->restore(); // restore translation/rotation state
-        }
-    } // End of RightAxis
+void KPlotWidget::drawAxes(QPainter *p)
+{
+    d->renderer.drawAxes(p);
 }
 
 int KPlotWidget::leftPadding() const
 {
-    if (d->leftPadding >= 0) {
-        return d->leftPadding;
-    }
-    const KPlotAxis *a = axis(LeftAxis);
-    if (a && a->isVisible() && a->areTickLabelsShown()) {
-        return !a->label().isEmpty() ? 3 * XPADDING : 2 * XPADDING;
-    }
-    return XPADDING;
+    return d->renderer.leftPadding();
 }
 
 int KPlotWidget::rightPadding() const
 {
-    if (d->rightPadding >= 0) {
-        return d->rightPadding;
-    }
-    const KPlotAxis *a = axis(RightAxis);
-    if (a && a->isVisible() && a->areTickLabelsShown()) {
-        return !a->label().isEmpty() ? 3 * XPADDING : 2 * XPADDING;
-    }
-    return XPADDING;
+    return d->renderer.rightPadding();
 }
 
 int KPlotWidget::topPadding() const
 {
-    if (d->topPadding >= 0) {
-        return d->topPadding;
-    }
-    const KPlotAxis *a = axis(TopAxis);
-    if (a && a->isVisible() && a->areTickLabelsShown()) {
-        return !a->label().isEmpty() ? 3 * YPADDING : 2 * YPADDING;
-    }
-    return YPADDING;
+    return d->renderer.topPadding();
 }
 
 int KPlotWidget::bottomPadding() const
 {
-    if (d->bottomPadding >= 0) {
-        return d->bottomPadding;
-    }
-    const KPlotAxis *a = axis(BottomAxis);
-    if (a && a->isVisible() && a->areTickLabelsShown()) {
-        return !a->label().isEmpty() ? 3 * YPADDING : 2 * YPADDING;
-    }
-    return YPADDING;
+    return d->renderer.bottomPadding();
 }
 
 void KPlotWidget::setLeftPadding(int padding)
 {
-    d->leftPadding = padding;
+    d->renderer.setLeftPadding(padding);
 }
 
 void KPlotWidget::setRightPadding(int padding)
 {
-    d->rightPadding = padding;
+    d->renderer.setRightPadding(padding);
 }
 
 void KPlotWidget::setTopPadding(int padding)
 {
-    d->topPadding = padding;
+    d->renderer.setTopPadding(padding);
 }
 
 void KPlotWidget::setBottomPadding(int padding)
 {
-    d->bottomPadding = padding;
+    d->renderer.setBottomPadding(padding);
 }
 
 void KPlotWidget::setDefaultPaddings()
 {
-    d->leftPadding = -1;
-    d->rightPadding = -1;
-    d->topPadding = -1;
-    d->bottomPadding = -1;
+    d->renderer.setDefaultPaddings();
 }
 
 #include "moc_kplotwidget.cpp"
@@ -18,6 +18,7 @@
 class KPlotAxis;
 class KPlotObject;
 class KPlotPoint;
+class KPlotRenderer;
 
 /*!
  * \class KPlotWidget
@@ -138,6 +139,26 @@ public:
         TopAxis,
     };
 
+    /*!
+     * The ways the user can change the data limits with the mouse.
+     *
+     * \value NoNavigation the limits are only set by the application
+     * \value WheelZoom the wheel zooms in and out around the cursor
+     * \value DragPan dragging with the left button moves the plot
+     * \value RubberBandZoom dragging a rectangle with the left button
+     *        zooms into it; with DragPan also enabled, the Shift key has
+     *        to be held down
+     *
+     * \since 6.28
+     */
+    enum NavigationMode {
+        NoNavigation = 0,
+        WheelZoom = 0x1,
+        DragPan = 0x2,
+        RubberBandZoom = 0x4,
+    };
+    Q_DECLARE_FLAGS(NavigationModes, NavigationMode)
+
     /*!
      * Returns suggested minimum size for the plot widget
      */
@@ -195,6 +216,40 @@ public:
      */
     void clearSecondaryLimits();
 
+    /*!
+     * Returns whether the axes of the given \a orientation use a
+     * logarithmic scale.
+     *
+     * Axes are linear by default.
+     *
+     * \sa setLogScale()
+     * \since 6.28
+     */
+    bool isLogScale(Qt::Orientation orientation) const;
+
+    /*!
+     * Toggle logarithmic (base 10) scaling for the axes of the given
+     * \a orientation.
+     *
+     * The data of the plot objects stay in their natural units; the
+     * logarithm is applied when they are mapped to the screen, and cached
+     * by each KPlotObject so that switching back and forth between linear
+     * and logarithmic scaling does not require re-adding the data.
+     * Tickmarks are placed at decades.
+     *
+     * \note a logarithmic scale only takes effect when the lower data limit
+     * of that orientation is positive.  Points with non-positive
+     * coordinates on a logarithmic axis are not drawn.
+     *
+     * \a orientation Qt::Horizontal for the bottom and top axes,
+     * Qt::Vertical for the left and right axes
+     *
+     * \a log if true, the axes will be logarithmic
+     *
+     * \since 6.28
+     */
+    void setLogScale(Qt::Orientation orientation, bool log);
+
     /*!
      * Returns the rectangle representing the boundaries of the current plot,
      * in natural data units.
@@ -210,6 +265,84 @@ public:
      */
     QRectF secondaryDataRect() const;
 
+    /*!
+     * Returns whether the data limits follow the points of the plot
+     * objects.
+     *
+     * Autoscaling is off by default.
+     *
+     * \sa setAutoScaling()
+     * \since 6.28
+     */
+    bool autoScaling() const;
+
+    /*!
+     * Set whether the data limits follow the points of the plot objects.
+     *
+     * When autoscaling is on, the limits are set to the extents of all
+     * points, see KPlotObject::boundingRect(), widened by
+     * autoScalePadding() on each side.  As points are added and removed
+     * the limits are only changed once the data leaves them, or shrinks
+     * enough that more than autoScaleHysteresis() of empty space would be
+     * left; new limits then leave half of that room.  This way streaming
+     * data does not rescale the plot for every new point.
+     *
+     * Each change of the limits is reported by limitsChanged().  Zooming
+     * or panning with the mouse turns autoscaling off.  On a logarithmic
+     * axis with positive data, the padding is applied to the logarithms.
+     *
+     * \sa setAutoScalePadding(), setAutoScaleHysteresis()
+     * \since 6.28
+     */
+    void setAutoScaling(bool b);
+
+    /*!
+     * Returns the space left around the data by autoscaling, as a fraction
+     * of the extent of the data.
+     *
+     * The default is 0.05.
+     *
+     * \sa setAutoScalePadding()
+     * \since 6.28
+     */
+    double autoScalePadding() const;
+
+    /*!
+     * Set the space left around the data on each side by autoscaling, as
+     * a fraction of the extent of the data.
+     *
+     * \a padding the fraction of the extent, 0 to fit the data exactly
+     *
+     * \sa setAutoScaling()
+     * \since 6.28
+     */
+    void setAutoScalePadding(double padding);
+
+    /*!
+     * Returns how much extra space autoscaling tolerates on each side of
+     * the padded data before it changes the limits, as a fraction of the
+     * extent of the data.
+     *
+     * The default is 0.1.
+     *
+     * \sa setAutoScaleHysteresis()
+     * \since 6.28
+     */
+    double autoScaleHysteresis() const;
+
+    /*!
+     * Set how much extra space autoscaling tolerates on each side of the
+     * padded data before it changes the limits, as a fraction of the
+     * extent of the data.
+     *
+     * \a hysteresis the fraction of the extent, 0 to change the limits
+     * whenever the data does
+     *
+     * \sa setAutoScaling()
+     * \since 6.28
+     */
+    void setAutoScaleHysteresis(double hysteresis);
+
     /*!
      * Returns the rectangle representing the boundaries of the current plot,
      * in screen pixel units.
@@ -221,6 +354,9 @@ public:
      *
      * The widget takes ownership of the plot object, unless auto-delete was disabled.
      *
+     * Later changes of the object repaint the part of the plot they
+     * affect, e.g. only the area of the points that were added.
+     *
      * \a object the KPlotObject to be added
      */
     void addPlotObject(KPlotObject *object);
@@ -242,7 +378,8 @@ public:
     /*!
      * Enables auto-deletion of plot objects if autoDelete is true; otherwise auto-deletion is disabled.
      *
-     * Auto-deletion is enabled by default.
+     * Auto-deletion is enabled by default.  Without it, a plot object
+     * deleted while the widget shows it is removed from the widget.
      *
      * \since 5.12
      */
@@ -338,6 +475,40 @@ public:
      */
     bool isObjectToolTipShown() const;
 
+    /*!
+     * Returns the point in the plot nearest to \a p, in the coordinates
+     * of the plot area, or nullptr if none is within pickRadius() pixels.
+     *
+     * The tooltips of the plot show the label of this point.
+     *
+     * \sa pointsUnderPoint()
+     *
+     * \since 6.28
+     */
+    KPlotPoint *nearestPoint(const QPoint &p) const;
+
+    /*!
+     * Returns the distance in pixels within which points are found for
+     * the tooltips, pointsUnderPoint() and nearestPoint().
+     *
+     * The default radius is 4.
+     *
+     * \sa KPlotRenderer::pickRadius()
+     *
+     * \since 6.28
+     */
+    int pickRadius() const;
+
+    /*!
+     * Set the distance in pixels within which points are found for the
+     * tooltips, pointsUnderPoint() and nearestPoint().
+     *
+     * \a radius the new pick radius
+     *
+     * \since 6.28
+     */
+    void setPickRadius(int radius);
+
     /*!
      * Returns whether the antialiasing is active
      *
@@ -352,6 +523,387 @@ public:
      */
     void setAntialiasing(bool b);
 
+    /*!
+     * Returns whether antialiasing is only used when the view is at rest
+     *
+     * Adaptive antialiasing is not active by default.
+     *
+     * \sa setAdaptiveAntialiasing()
+     * \since 6.28
+     */
+    bool adaptiveAntialiasing() const;
+
+    /*!
+     * Toggle adaptive antialiasing.
+     *
+     * Antialiasing makes drawing several times slower.  When adaptive
+     * antialiasing is enabled, frames painted after the widget was
+     * resized, the limits were changed or a plot object was modified are
+     * drawn aliased, and the plot is drawn antialiased again once nothing
+     * changed for antialiasingDelay().  Panning, zooming and streaming
+     * data thus get the frame rate of aliased drawing.
+     *
+     * This has no effect unless antialiasing() is enabled.
+     *
+     * \a b if true, antialiasing is skipped while the view changes.
+     *
+     * \sa setAntialiasingDelay()
+     * \since 6.28
+     */
+    void setAdaptiveAntialiasing(bool b);
+
+    /*!
+     * Returns the time in milliseconds that the view has to be idle before
+     * it is drawn antialiased again, in adaptive antialiasing mode
+     *
+     * The default is 250 milliseconds.
+     *
+     * \sa setAdaptiveAntialiasing()
+     * \since 6.28
+     */
+    int antialiasingDelay() const;
+
+    /*!
+     * Set the time that the view has to be idle before it is drawn
+     * antialiased again, in adaptive antialiasing mode.
+     *
+     * \a msec the delay in milliseconds
+     *
+     * \sa setAdaptiveAntialiasing()
+     * \since 6.28
+     */
+    void setAntialiasingDelay(int msec);
+
+    /*!
+     * Returns whether each plot object is rendered into its own cached layer
+     *
+     * Layer caching is not active by default.
+     *
+     * \sa setObjectLayerCaching()
+     * \since 6.28
+     */
+    bool objectLayerCaching() const;
+
+    /*!
+     * Toggle caching of the rendered plot objects.
+     *
+     * When enabled, each KPlotObject is rendered into its own image,
+     * which is kept until the data or style of that object, the data
+     * limits, the size of the plot area or the antialiasing setting
+     * change.  Repaints then only re-render the objects that changed and
+     * composite the cached images in the order of plotObjects().
+     *
+     * \note with layer caching, the labels of an object only avoid the
+     * points, lines and labels of that same object.
+     *
+     * \a b if true, the plot objects are cached.
+     *
+     * \since 6.28
+     */
+    void setObjectLayerCaching(bool b);
+
+    /*!
+     * Returns whether the grid, the axes and their labels are rendered
+     * into a cached layer
+     *
+     * Axes caching is not active by default.
+     *
+     * \sa setAxesCaching()
+     * \since 6.28
+     */
+    bool axesCaching() const;
+
+    /*!
+     * Toggle caching of the rendered grid, axes and labels.
+     *
+     * When enabled, drawAxes() renders into an image that is reused until
+     * the data limits, the paddings, the widget size or font, the
+     * background, foreground or grid color, or a property of one of the
+     * axes change.
+     * Repaints with fixed limits, like those of a plot that is updated
+     * with new data, then only draw the plot objects.
+     *
+     * \note if drawAxes() is reimplemented to draw state that is not
+     * known to KPlotWidget, toggle the caching off and on again to
+     * refresh the layer after changing that state.
+     *
+     * \a b if true, the axes are cached.
+     *
+     * \since 6.28
+     */
+    void setAxesCaching(bool b);
+
+    /*!
+     * Returns whether the plot is drawn as a scrolling strip chart
+     *
+     * Strip chart mode is not active by default.
+     *
+     * \sa setStripChartMode()
+     * \since 6.28
+     */
+    bool stripChartMode() const;
+
+    /*!
+     * Toggle strip chart mode.
+     *
+     * In strip chart mode the plot objects are rendered into cached
+     * layers, as with setObjectLayerCaching().  When the x limits are only
+     * shifted, e.g. to follow a stream of data, and points were only
+     * added to an object since its last rendering, the layer is scrolled
+     * by the shift in whole pixels, and only the strip that was exposed
+     * and the new points are drawn.  The cost of a frame then depends on
+     * the amount of new data rather than on the number of points shown.
+     *
+     * Scrolled layers can be up to half a pixel off the exact positions.
+     * Objects with bars or labelled points are always rendered as a whole.
+     *
+     * \a b if true, strip chart mode is enabled.
+     *
+     * \sa setLimits(), KPlotObject::addPoint()
+     * \since 6.28
+     */
+    void setStripChartMode(bool b);
+
+    /*!
+     * Returns whether the plot objects are rasterized on several threads
+     *
+     * Parallel rendering is not active by default.
+     *
+     * \sa setParallelRendering()
+     * \since 6.28
+     */
+    bool parallelRendering() const;
+
+    /*!
+     * Toggle parallel rendering of the plot objects.
+     *
+     * When enabled, the plot area is split into tiles, which are
+     * rasterized on the threads of QThreadPool::globalInstance() and then
+     * joined.  This speeds up the drawing of plots with many points on
+     * machines with several cores.
+     *
+     * Label placement depends on everything drawn before, so objects
+     * with labelled points are still drawn on the GUI thread.  Objects
+     * whose points are not sorted by x can not be split into columns
+     * cheaply, so they are drawn whole on the GUI thread as well.
+     *
+     * \a b if true, the plot objects are rendered in parallel.
+     *
+     * \since 6.28
+     */
+    void setParallelRendering(bool b);
+
+    /*!
+     * Returns whether the plot objects are rendered asynchronously
+     *
+     * Asynchronous rendering is not active by default.
+     *
+     * \sa setAsyncRendering()
+     * \since 6.28
+     */
+    bool asyncRendering() const;
+
+    /*!
+     * Toggle asynchronous rendering of the plot objects.
+     *
+     * When enabled, the plot objects are rendered on a thread of
+     * QThreadPool::globalInstance(), from a copy of their state and of
+     * the data limits.  Repaints show the most recently completed frame,
+     * so the event loop never waits for the rendering, and the widget is
+     * repainted again when the frame for the current state is ready.  One
+     * frame is rendered at a time; changes made meanwhile are rendered
+     * together in the next frame, once the current one is shown.
+     *
+     * The axes are drawn synchronously, so they can be ahead of the plot
+     * objects for a moment.
+     *
+     * \a b if true, the plot objects are rendered asynchronously.
+     *
+     * \since 6.28
+     */
+    void setAsyncRendering(bool b);
+
+    /*!
+     * Returns whether the plot objects are rendered progressively
+     *
+     * Progressive rendering is not active by default.
+     *
+     * \sa setProgressiveRendering()
+     * \since 6.28
+     */
+    bool progressiveRendering() const;
+
+    /*!
+     * Toggle progressive rendering of the plot objects.
+     *
+     * When enabled, the first repaint after a change draws a preview of
+     * the plot objects from a few points per pixel column: the first,
+     * last, lowest and highest point of each column for objects sorted by
+     * x, an even sample of the points otherwise.  Later iterations of the
+     * event loop then replace the preview with the full rendering, strip
+     * by strip, spending about frameBudget() on each repaint, so that the
+     * widget stays responsive while plots with millions of points are
+     * drawn.  frameCompleted() is emitted when the full rendering is done.
+     *
+     * Label placement depends on everything drawn before, so plots with
+     * labelled points are rendered in full at once.  So are plots with
+     * objects whose points are not sorted by x, as every strip would
+     * have to go through all of their points.
+     *
+     * \a b if true, the plot objects are rendered progressively.
+     *
+     * \sa setFrameBudget()
+     * \since 6.28
+     */
+    void setProgressiveRendering(bool b);
+
+    /*!
+     * Returns the time in milliseconds that a repaint may spend on
+     * progressive rendering
+     *
+     * The default is 16 milliseconds.
+     *
+     * \sa setFrameBudget()
+     * \since 6.28
+     */
+    int frameBudget() const;
+
+    /*!
+     * Set the time that a repaint may spend on progressive rendering.
+     *
+     * Each repaint renders at least one strip of the plot, and then goes
+     * on until \a msec milliseconds have passed since it started.
+     *
+     * \a msec the budget in milliseconds
+     *
+     * \sa setProgressiveRendering()
+     * \since 6.28
+     */
+    void setFrameBudget(int msec);
+
+    /*!
+     * Returns the ways the user can change the data limits with the mouse
+     *
+     * Navigation is not enabled by default.
+     *
+     * \sa setNavigationModes()
+     * \since 6.28
+     */
+    NavigationModes navigationModes() const;
+
+    /*!
+     * Set the ways the user can change the data limits with the mouse.
+     *
+     * While the user zooms or pans, the plot objects are not rendered
+     * again for each step: the last rendering of them is scaled and moved
+     * to the new limits instead, so navigation stays smooth however many
+     * points are plotted.  They are rendered again once the view has not
+     * changed for navigationDelay() milliseconds.  The axes are always
+     * drawn for the current limits.
+     *
+     * Each change of the limits by the user is reported by
+     * limitsChanged().  The secondary limits are not changed.
+     *
+     * \a modes the navigation modes to enable
+     *
+     * \since 6.28
+     */
+    void setNavigationModes(NavigationModes modes);
+
+    /*!
+     * Returns the time in milliseconds after the last step of a
+     * navigation until the plot objects are rendered again
+     *
+     * The default delay is 150 milliseconds.
+     *
+     * \sa setNavigationModes()
+     * \since 6.28
+     */
+    int navigationDelay() const;
+
+    /*!
+     * Set the time after the last step of a navigation until the plot
+     * objects are rendered again.
+     *
+     * \a msec the delay in milliseconds
+     *
+     * \since 6.28
+     */
+    void setNavigationDelay(int msec);
+
+    /*!
+     * Returns the highest number of times per second that the widget
+     * repaints itself for changes of the plot
+     *
+     * The frame rate is not limited by default.
+     *
+     * \sa setMaximumFrameRate()
+     * \since 6.28
+     */
+    int maximumFrameRate() const;
+
+    /*!
+     * Set the highest number of times per second that the widget repaints
+     * itself for changes of the plot.
+     *
+     * When points are added or settings change faster than that, the
+     * repaints they request are merged: the widget repaints what changed
+     * once the next frame is due, instead of after each change.  Exposing
+     * the widget and calling update() directly still repaint it right
+     * away.
+     *
+     * \a fps the maximum frame rate, or 0 for no limit
+     *
+     * \sa mergedUpdateCount()
+     * \since 6.28
+     */
+    void setMaximumFrameRate(int fps);
+
+    /*!
+     * Returns how many repaints requested by changes of the plot were
+     * merged into a repaint that was already due, because of the maximum
+     * frame rate.
+     *
+     * \sa setMaximumFrameRate()
+     * \since 6.28
+     */
+    qint64 mergedUpdateCount() const;
+
+    /*!
+     * Start a batch of changes to the plot.
+     *
+     * Until the matching endUpdate(), changes of the limits, the plot
+     * objects and the drawing options do not repaint the widget, and the
+     * tickmarks of the axes are not recomputed for new limits.  Setting up
+     * a whole plot then costs one computation of the tickmarks and one
+     * repaint when the batch ends.  Calls can be nested; only the
+     * outermost endUpdate() ends the batch.
+     *
+     * \note during a batch, KPlotAxis::majorTickMarks() and
+     * KPlotAxis::minorTickMarks() can be out of date.
+     *
+     * \sa endUpdate(), isUpdating(), KPlotObject::beginUpdate()
+     * \since 6.28
+     */
+    void beginUpdate();
+
+    /*!
+     * End a batch of changes started with beginUpdate(), updating the
+     * tickmarks and repainting what changed during it.
+     *
+     * \sa beginUpdate()
+     * \since 6.28
+     */
+    void endUpdate();
+
+    /*!
+     * Returns whether a batch of changes started with beginUpdate() has
+     * not ended yet.
+     *
+     * \since 6.28
+     */
+    bool isUpdating() const;
+
     /*!
      * Returns the number of pixels to the left of the plot area.
      *
@@ -511,6 +1063,25 @@ public Q_SLOTS:
      */
     void setObjectToolTipShown(bool show);
 
+Q_SIGNALS:
+    /*!
+     * Emitted in progressive rendering mode when the plot objects were
+     * painted in full for the current state of the plot.
+     *
+     * \sa setProgressiveRendering()
+     * \since 6.28
+     */
+    void frameCompleted();
+
+    /*!
+     * Emitted when the user changed the data limits to \a dataRect by
+     * zooming or panning, or when autoscaling changed them.
+     *
+     * \sa setNavigationModes(), setAutoScaling()
+     * \since 6.28
+     */
+    void limitsChanged(const QRectF &dataRect);
+
 protected:
     bool event(QEvent *) override;
 
@@ -518,6 +1089,14 @@ protected:
 
     void resizeEvent(QResizeEvent *) override;
 
+    void mousePressEvent(QMouseEvent *) override;
+
+    void mouseMoveEvent(QMouseEvent *) override;
+
+    void mouseReleaseEvent(QMouseEvent *) override;
+
+    void wheelEvent(QWheelEvent *) override;
+
     /*!
      * Draws the plot axes and axis labels.
      * \internal
@@ -535,18 +1114,33 @@ protected:
     void setPixRect();
 
     /*!
-     * Returns a list of points in the plot which are within 4 pixels
-     * of the screen position given as an argument.
+     * Returns a list of points in the plot which are within pickRadius()
+     * pixels of the screen position given as an argument.
      *
      * \a p The screen position from which to check for plot points.
      */
     QList<KPlotPoint *> pointsUnderPoint(const QPoint &p) const;
 
 private:
+    friend class KPlotObject;
+    /*
+     * Schedule the repaint of what changed in object: the points from
+     * index first on were added or changed their style, or any point may
+     * have moved if first is negative.
+     */
+    void plotObjectChanged(KPlotObject *object, qsizetype first);
+    // Start or stop taking the samples queued in the plot objects
+    void sampleQueueChanged();
+    // Forget object, which is being deleted while the widget shows it
+    void plotObjectDestroyed(KPlotObject *object);
+    // The renderer that holds the plot and that KPlotObject::draw() uses
+    KPlotRenderer *renderer() const;
+
     class Private;
     std::unique_ptr<Private> const d;
 
     Q_DISABLE_COPY(KPlotWidget)
 };
+Q_DECLARE_OPERATORS_FOR_FLAGS(KPlotWidget::NavigationModes)
 
 #endif